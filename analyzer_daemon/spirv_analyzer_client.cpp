@@ -0,0 +1,96 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_analyzer_client.h"
+
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+bool SpirVAnalyzerClient::Submit(uint64_t request_id, SpirVAnalyzerPass pass, const uint32_t* spirv_code,
+                                 size_t spirv_num_bytes)
+{
+    SpirVAnalyzerRequest request;
+    request.request_id = request_id;
+    request.pass       = static_cast<uint32_t>(pass);
+    request.num_bytes  = spirv_num_bytes;
+    return socket_.Send(&request, sizeof(request)) && socket_.Send(spirv_code, spirv_num_bytes);
+}
+
+bool SpirVAnalyzerClient::SubmitShared(uint64_t request_id, SpirVAnalyzerPass pass, int descriptor)
+{
+    SpirVAnalyzerRequest request;
+    request.request_id = request_id;
+    request.pass       = static_cast<uint32_t>(pass);
+    request.flags      = kSpirVAnalyzerFlagSharedMemory;
+    return socket_.SendWithDescriptor(&request, sizeof(request), descriptor);
+}
+
+bool SpirVAnalyzerClient::Receive(SpirVAnalyzerResponse& response, std::vector<uint8_t>& payload)
+{
+    if (!socket_.Receive(&response, sizeof(response)) || response.magic != kSpirVAnalyzerMagic)
+    {
+        return false;
+    }
+    payload.resize(static_cast<size_t>(response.payload_bytes));
+    return payload.empty() || socket_.Receive(payload.data(), payload.size());
+}
+
+int SpirVAnalyzerClient::CreateSharedModule(const uint32_t* spirv_code, size_t spirv_num_bytes)
+{
+#if defined(__linux__)
+    const int descriptor = memfd_create("spirv-module", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (descriptor < 0)
+    {
+        return -1;
+    }
+
+    const auto* bytes     = reinterpret_cast<const char*>(spirv_code);
+    size_t      remaining = spirv_num_bytes;
+    while (remaining > 0)
+    {
+        const ssize_t written = write(descriptor, bytes, remaining);
+        if (written <= 0)
+        {
+            close(descriptor);
+            return -1;
+        }
+        bytes += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    // the daemon only maps sealed descriptors, the module can't change under it from here on
+    if (fcntl(descriptor, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0)
+    {
+        close(descriptor);
+        return -1;
+    }
+    return descriptor;
+#else
+    (void)spirv_code;
+    (void)spirv_num_bytes;
+    return -1;
+#endif
+}
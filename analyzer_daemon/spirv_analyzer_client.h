@@ -0,0 +1,66 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_ANALYZER_DAEMON_SPIRV_ANALYZER_CLIENT_H
+#define SPIRV_PARSING_ANALYZER_DAEMON_SPIRV_ANALYZER_CLIENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "spirv_analyzer_protocol.h"
+#include "spirv_analyzer_socket.h"
+
+// SpirVAnalyzerClient is one connection to spirv-analyzerd.
+//
+// Submit as many modules as there are, then collect the responses; they come back in whatever order the daemon's
+// workers finish them. Submitting and receiving may run on two threads, which keeps both directions of the socket
+// moving when a large batch is in flight.
+class SpirVAnalyzerClient
+{
+  public:
+    bool Connect(const char* socket_path) { return socket_.Connect(socket_path); }
+
+    void Close() { socket_.Close(); }
+
+    //! send the module through the socket, false if the connection failed
+    bool Submit(uint64_t request_id, SpirVAnalyzerPass pass, const uint32_t* spirv_code, size_t spirv_num_bytes);
+
+    //! hand over a memfd/shm descriptor holding the module, the daemon maps it instead of receiving the bytes.
+    //! The descriptor stays owned by the caller and can be closed once this returns
+    bool SubmitShared(uint64_t request_id, SpirVAnalyzerPass pass, int descriptor);
+
+    //! no more submissions, the daemon closes the connection once every response was sent
+    void FinishSubmitting() { socket_.ShutdownSend(); }
+
+    //! wait for the next response, false once the connection is gone. 'payload' is resized to the payload
+    bool Receive(SpirVAnalyzerResponse& response, std::vector<uint8_t>& payload);
+
+    //! copy a module into a new anonymous shared-memory file for SubmitShared(), sealed against any further change.
+    //! -1 where memfd is unavailable
+    static int CreateSharedModule(const uint32_t* spirv_code, size_t spirv_num_bytes);
+
+  private:
+    SpirVAnalyzerSocket socket_{};
+};
+
+#endif // SPIRV_PARSING_ANALYZER_DAEMON_SPIRV_ANALYZER_CLIENT_H
@@ -0,0 +1,94 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_ANALYZER_DAEMON_SPIRV_ANALYZER_PROTOCOL_H
+#define SPIRV_PARSING_ANALYZER_DAEMON_SPIRV_ANALYZER_PROTOCOL_H
+
+#include <cstdint>
+
+// Wire format between spirv-analyzerd and its clients, over a Unix domain stream socket.
+//
+// A client sends any number of requests without waiting for the answers; the daemon spreads them over its workers
+// and answers each one as soon as it is done, so responses can arrive out of order and are matched by request_id.
+// A client has a bounded number of requests in flight (queued, analyzed or answered but not read yet); beyond that
+// the daemon stops reading from its socket until the client reads answers, so a client that never reads blocks only
+// itself.
+//
+// Every request is a SpirVAnalyzerRequest followed by the module, either
+//  - inline: 'num_bytes' bytes of SPIR-V words follow the header on the socket, or
+//  - shared: no bytes follow, a memfd descriptor holding the module is passed with the header (SCM_RIGHTS).
+//    The daemon maps it read-only, so large modules are never copied through the socket. The memfd has to be sealed
+//    with F_SEAL_SHRINK and F_SEAL_WRITE, anything else is answered with BAD_REQUEST. Only sealed memfds are
+//    supported: POSIX shared memory (shm_open), tmpfs and regular files can't be sealed, so they are always rejected;
+//    send those modules inline.
+//
+// Every response is a SpirVAnalyzerResponse followed by 'payload_bytes' bytes of results:
+//  - BDA_ADDRESS*: the buffer-references with their access-chain names, in the format of spirv_buffer_reference_file.h
+//  - VERTEX_INPUT_POSITION: the VertexInputPositionAnalyzer::Status as uint32_t, then the sorted Locations
+// All values are in the host's byte order, both ends are on the same machine.
+
+constexpr uint32_t kSpirVAnalyzerMagic           = 0x44415053;  // "SPAD"
+constexpr uint32_t kSpirVAnalyzerProtocolVersion = 2;
+
+enum class SpirVAnalyzerPass : uint32_t
+{
+    BDA_ADDRESS = 0,
+    //! BDA_ADDRESS with the struct layouts taken from SPIRV-Reflect
+    BDA_ADDRESS_REFLECT,
+    VERTEX_INPUT_POSITION
+};
+
+enum class SpirVAnalyzerStatus : uint32_t
+{
+    SUCCESS = 0,
+    //! the module was received but the pass could not analyze it, there is no payload
+    ANALYSIS_FAILED,
+    //! unknown pass, a missing descriptor or a module that could not be mapped, there is no payload
+    BAD_REQUEST
+};
+
+//! the module was handed over as a descriptor instead of inline
+constexpr uint32_t kSpirVAnalyzerFlagSharedMemory = 0x1;
+
+struct SpirVAnalyzerRequest
+{
+    uint32_t magic      = kSpirVAnalyzerMagic;
+    uint32_t version    = kSpirVAnalyzerProtocolVersion;
+    uint64_t request_id = 0;
+    uint32_t pass       = 0;
+    uint32_t flags      = 0;
+    //! bytes following inline, 0 for shared modules (the size of the mapping is used)
+    uint64_t num_bytes = 0;
+};
+
+struct SpirVAnalyzerResponse
+{
+    uint32_t magic         = kSpirVAnalyzerMagic;
+    uint32_t status        = 0;
+    uint64_t request_id    = 0;
+    uint64_t payload_bytes = 0;
+};
+
+static_assert(sizeof(SpirVAnalyzerRequest) == 32, "the request header is part of the wire format");
+static_assert(sizeof(SpirVAnalyzerResponse) == 24, "the response header is part of the wire format");
+
+#endif // SPIRV_PARSING_ANALYZER_DAEMON_SPIRV_ANALYZER_PROTOCOL_H
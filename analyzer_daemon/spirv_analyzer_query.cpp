@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "spirv_analyzer_client.h"
+#include "spirv_batch.h"
+#include "spirv_buffer_reference_file.h"
+#include "spirv_file.h"
+#include "spirv_parsing_util.h"
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct ModuleResult {
+    bool opened = false;
+    bool answered = false;
+    SpirVAnalyzerResponse response;
+    std::vector<uint8_t> payload;
+    size_t num_bytes = 0;
+    Clock::time_point submit_time;
+    Clock::time_point answer_time;
+};
+
+void PrintBufferReferences(const std::vector<uint8_t>& payload) {
+    SpirVBufferReferenceFileReader references;
+    if (!references.Open(payload.data(), payload.size())) {
+        printf("ERROR: Malformed buffer-reference results\n");
+        return;
+    }
+    // the same format as bda_address
+    for (size_t i = 0; i < references.size(); i++) {
+        const SpirVParsingUtil::BufferReferenceInfo reference = references.GetInfo(i);
+        std::string name;
+        for (uint32_t element = 0; element < references.GetChainLength(i); element++) {
+            name += element == 0 ? "" : " -> ";
+            name += references.GetChainName(i, element);
+        }
+
+        char location[64] = {};
+        switch (reference.source) {
+            case SpirVParsingUtil::BufferReferenceLocation::PUSH_CONSTANT_BLOCK:
+                snprintf(location, sizeof(location), "push-constant-block");
+                break;
+            case SpirVParsingUtil::BufferReferenceLocation::SHADER_RECORD_BUFFER:
+                snprintf(location, sizeof(location), "shader-record-buffer");
+                break;
+            case SpirVParsingUtil::BufferReferenceLocation::UNIFORM_BUFFER:
+            case SpirVParsingUtil::BufferReferenceLocation::STORAGE_BUFFER:
+                snprintf(location, sizeof(location), "set: %u, binding: %u", reference.set, reference.binding);
+                break;
+            default:
+                break;
+        }
+        printf("buffer-reference: %s (%s, buffer-offset: %u, array-stride: %u)\n", name.c_str(), location,
+               reference.buffer_offset, reference.array_stride);
+    }
+}
+
+void PrintVertexInputPosition(const std::vector<uint8_t>& payload) {
+    std::vector<uint32_t> words(payload.size() / sizeof(uint32_t));
+    memcpy(words.data(), payload.data(), words.size() * sizeof(uint32_t));
+    if (words.empty()) {
+        return;
+    }
+    printf("status: %u, Position is stored using Input Locations:", words[0]);
+    for (size_t i = 1; i < words.size(); i++) {
+        printf(" %u", words[i]);
+    }
+    printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string socket_path = SpirVAnalyzerDefaultSocketPath();
+    auto pass = SpirVAnalyzerPass::BDA_ADDRESS;
+    // --shared hands every module over in a memfd instead of sending it through the socket
+    bool shared = false;
+    SpirVBatch batch;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (arg == "--pass" && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (name == "bda") {
+                pass = SpirVAnalyzerPass::BDA_ADDRESS;
+            } else if (name == "bda-reflect") {
+                pass = SpirVAnalyzerPass::BDA_ADDRESS_REFLECT;
+            } else if (name == "vertex") {
+                pass = SpirVAnalyzerPass::VERTEX_INPUT_POSITION;
+            } else {
+                std::cout << "ERROR: Unknown pass " << name << "\n";
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--shared") {
+            shared = true;
+        } else if (arg == "--manifest" && i + 1 < argc) {
+            if (!batch.AddManifest(argv[++i])) {
+                std::cout << "ERROR: Unable to read the manifest " << argv[i] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else if (!batch.AddInput(arg)) {
+            std::cout << "ERROR: " << arg << " Does not exists\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (batch.files().empty()) {
+        std::cout << "Usage:\n\t" << argv[0]
+                  << " [--socket PATH] [--pass bda|bda-reflect|vertex] [--shared] [--manifest list.txt]"
+                     " (input.spv | directory)...\n";
+        return EXIT_FAILURE;
+    }
+
+    SpirVAnalyzerClient client;
+    if (!client.Connect(socket_path.c_str())) {
+        std::cout << "ERROR: No spirv-analyzerd listening on " << socket_path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<ModuleResult> results(batch.files().size());
+    auto batch_start_time = Clock::now();
+
+    // answers are collected while the modules are still being sent, so neither side stalls on a full socket
+    std::thread receiver([&] {
+        SpirVAnalyzerResponse response;
+        std::vector<uint8_t> payload;
+        while (client.Receive(response, payload)) {
+            if (response.request_id < results.size()) {
+                ModuleResult& result = results[response.request_id];
+                result.answered = true;
+                result.response = response;
+                result.payload.swap(payload);
+                result.answer_time = Clock::now();
+            }
+        }
+    });
+
+    SpirVFile spirv;
+    for (size_t i = 0; i < batch.files().size(); i++) {
+        ModuleResult& result = results[i];
+        if (!spirv.Open(batch.files()[i].c_str())) {
+            continue;
+        }
+        result.opened = true;
+        result.num_bytes = spirv.size_bytes();
+        result.submit_time = Clock::now();
+
+        bool submitted;
+        if (shared) {
+            const int descriptor = SpirVAnalyzerClient::CreateSharedModule(spirv.data(), spirv.size_bytes());
+            submitted = descriptor >= 0 && client.SubmitShared(i, pass, descriptor);
+            if (descriptor >= 0) {
+                close(descriptor);
+            }
+        } else {
+            submitted = client.Submit(i, pass, spirv.data(), spirv.size_bytes());
+        }
+        if (!submitted) {
+            std::cout << "ERROR: Unable to submit " << batch.files()[i] << "\n";
+            break;
+        }
+    }
+    client.FinishSubmitting();
+    receiver.join();
+
+    std::chrono::duration<double, std::milli> duration = Clock::now() - batch_start_time;
+
+    SpirVBatch::Stats stats;
+    stats.duration_ms = duration.count();
+    double total_latency_ms = 0.0;
+    double max_latency_ms = 0.0;
+    size_t num_answered = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        const ModuleResult& result = results[i];
+        printf("== %s ==\n", batch.files()[i].c_str());
+        stats.num_modules++;
+        stats.num_bytes += result.num_bytes;
+        if (!result.opened) {
+            printf("ERROR: Unable to open the input file %s\n", batch.files()[i].c_str());
+            stats.num_failed++;
+            continue;
+        }
+        if (!result.answered) {
+            printf("ERROR: No answer for %s\n", batch.files()[i].c_str());
+            stats.num_failed++;
+            continue;
+        }
+
+        const auto status = static_cast<SpirVAnalyzerStatus>(result.response.status);
+        if (status == SpirVAnalyzerStatus::BAD_REQUEST) {
+            printf("ERROR: The daemon rejected the request\n");
+        } else if (pass == SpirVAnalyzerPass::VERTEX_INPUT_POSITION) {
+            PrintVertexInputPosition(result.payload);
+        } else if (status == SpirVAnalyzerStatus::SUCCESS) {
+            PrintBufferReferences(result.payload);
+        } else {
+            printf("ERROR: The daemon could not analyze the module\n");
+        }
+        stats.num_failed += status == SpirVAnalyzerStatus::SUCCESS ? 0 : 1;
+
+        const double latency_ms =
+            std::chrono::duration<double, std::milli>(result.answer_time - result.submit_time).count();
+        total_latency_ms += latency_ms;
+        num_answered++;
+        max_latency_ms = std::max(max_latency_ms, latency_ms);
+    }
+    SpirVBatch::PrintStats(stats);
+    // only answered modules have a latency
+    if (num_answered > 0) {
+        printf("Latency = %.3f ms average, %.3f ms max\n", total_latency_ms / static_cast<double>(num_answered),
+               max_latency_ms);
+    }
+
+    return stats.num_failed == 0 ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,290 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_analyzer_socket.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// not every platform has these, the daemon ignores SIGPIPE anyway
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#ifndef MSG_CMSG_CLOEXEC
+#define MSG_CMSG_CLOEXEC 0
+#endif
+
+namespace
+{
+bool MakeAddress(const char* path, sockaddr_un& address)
+{
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+    strcpy(address.sun_path, path);
+    return true;
+}
+}  // namespace
+
+SpirVAnalyzerSocket::~SpirVAnalyzerSocket()
+{
+    Close();
+}
+
+bool SpirVAnalyzerSocket::Connect(const char* path)
+{
+    Close();
+    sockaddr_un address;
+    if (!MakeAddress(path, address))
+    {
+        return false;
+    }
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0 || connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool SpirVAnalyzerSocket::Listen(const char* path)
+{
+    Close();
+    sockaddr_un address;
+    if (!MakeAddress(path, address))
+    {
+        return false;
+    }
+
+    // only a socket is assumed to be left over from an earlier run, a mistyped --socket must not delete a file
+    struct stat existing;
+    if (lstat(path, &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+        {
+            errno = EEXIST;
+            return false;
+        }
+        unlink(path);
+    }
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0)
+    {
+        return false;
+    }
+
+    // the file gets its mode when it is bound, so there is no window in which other users can connect. The umask is
+    // per process, Listen() runs before the daemon starts any thread
+    const mode_t previous_umask = umask(0177);
+    const bool   bound          = bind(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    umask(previous_umask);
+    if (!bound || listen(fd_, SOMAXCONN) != 0)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+int SpirVAnalyzerSocket::Accept() const
+{
+    for (;;)
+    {
+        const int client = accept(fd_, nullptr, nullptr);
+        if (client >= 0 || errno != EINTR)
+        {
+            return client;
+        }
+    }
+}
+
+void SpirVAnalyzerSocket::Shutdown() const
+{
+    if (fd_ >= 0)
+    {
+        shutdown(fd_, SHUT_RDWR);
+    }
+}
+
+void SpirVAnalyzerSocket::ShutdownSend() const
+{
+    if (fd_ >= 0)
+    {
+        shutdown(fd_, SHUT_WR);
+    }
+}
+
+void SpirVAnalyzerSocket::Close()
+{
+    if (fd_ >= 0)
+    {
+        close(fd_);
+    }
+    fd_ = -1;
+}
+
+bool SpirVAnalyzerSocket::Send(const void* data, size_t num_bytes) const
+{
+    return SendWithDescriptor(data, num_bytes, -1);
+}
+
+bool SpirVAnalyzerSocket::SendWithDescriptor(const void* data, size_t num_bytes, int descriptor) const
+{
+    const auto* bytes = static_cast<const char*>(data);
+    while (num_bytes > 0)
+    {
+        iovec  io = {const_cast<char*>(bytes), num_bytes};
+        msghdr message{};
+        message.msg_iov    = &io;
+        message.msg_iovlen = 1;
+
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        if (descriptor >= 0)
+        {
+            memset(control, 0, sizeof(control));
+            message.msg_control    = control;
+            message.msg_controllen = sizeof(control);
+            cmsghdr* header        = CMSG_FIRSTHDR(&message);
+            header->cmsg_level     = SOL_SOCKET;
+            header->cmsg_type      = SCM_RIGHTS;
+            header->cmsg_len       = CMSG_LEN(sizeof(int));
+            memcpy(CMSG_DATA(header), &descriptor, sizeof(int));
+        }
+
+        // a peer that went away must fail the send, not kill the process with SIGPIPE
+        const ssize_t sent = sendmsg(fd_, &message, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        // the descriptor went out with the first chunk
+        descriptor = -1;
+        bytes += sent;
+        num_bytes -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool SpirVAnalyzerSocket::Receive(void* data, size_t num_bytes) const
+{
+    auto* bytes = static_cast<char*>(data);
+    while (num_bytes > 0)
+    {
+        const ssize_t received = recv(fd_, bytes, num_bytes, 0);
+        if (received <= 0)
+        {
+            if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        bytes += received;
+        num_bytes -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+bool SpirVAnalyzerSocket::ReceiveWithDescriptor(void* data, size_t num_bytes, int& descriptor) const
+{
+    descriptor  = -1;
+    auto* bytes = static_cast<char*>(data);
+    while (num_bytes > 0)
+    {
+        iovec  io = {bytes, num_bytes};
+        msghdr message{};
+        message.msg_iov    = &io;
+        message.msg_iovlen = 1;
+
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        message.msg_control    = control;
+        message.msg_controllen = sizeof(control);
+
+        const ssize_t received = recvmsg(fd_, &message, MSG_CMSG_CLOEXEC);
+        if (received <= 0)
+        {
+            if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header))
+        {
+            if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+            {
+                continue;
+            }
+            // keep the first descriptor, any others would only leak
+            const size_t num_descriptors = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (size_t i = 0; i < num_descriptors; i++)
+            {
+                int received_descriptor;
+                memcpy(&received_descriptor, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+                if (descriptor < 0)
+                {
+                    descriptor = received_descriptor;
+                }
+                else
+                {
+                    close(received_descriptor);
+                }
+            }
+        }
+        bytes += received;
+        num_bytes -= static_cast<size_t>(received);
+    }
+
+    if (num_bytes > 0 && descriptor >= 0)
+    {
+        close(descriptor);
+        descriptor = -1;
+    }
+    return num_bytes == 0;
+}
+
+std::string SpirVAnalyzerDefaultSocketPath()
+{
+    const char* runtime_directory = getenv("XDG_RUNTIME_DIR");
+    if (runtime_directory != nullptr && runtime_directory[0] != '\0')
+    {
+        return std::string(runtime_directory) + "/spirv-analyzerd.sock";
+    }
+    return "/tmp/spirv-analyzerd.sock";
+}
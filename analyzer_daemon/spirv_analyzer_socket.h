@@ -0,0 +1,81 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_ANALYZER_DAEMON_SPIRV_ANALYZER_SOCKET_H
+#define SPIRV_PARSING_ANALYZER_DAEMON_SPIRV_ANALYZER_SOCKET_H
+
+#include <cstddef>
+#include <string>
+
+// SpirVAnalyzerSocket owns one end of a Unix domain stream socket and moves whole messages over it, retrying short
+// reads and writes. A descriptor can travel along with a message (SCM_RIGHTS), which is how shared modules are passed.
+//
+// Sending and receiving may happen on different threads at the same time, but not two sends or two receives.
+class SpirVAnalyzerSocket
+{
+  public:
+    SpirVAnalyzerSocket() = default;
+    explicit SpirVAnalyzerSocket(int fd) : fd_(fd) {}
+    ~SpirVAnalyzerSocket();
+
+    SpirVAnalyzerSocket(const SpirVAnalyzerSocket&)            = delete;
+    SpirVAnalyzerSocket& operator=(const SpirVAnalyzerSocket&) = delete;
+
+    //! connect to the daemon listening on 'path', returns false if nothing is listening there
+    bool Connect(const char* path);
+
+    //! bind and listen on 'path', replacing a stale socket file left by an earlier run. Anything at 'path' that isn't
+    //! a socket is left alone and fails. The socket file is only accessible to its owner (0600)
+    bool Listen(const char* path);
+
+    //! wait for the next client and return its descriptor, -1 once the listening socket fails or is shut down
+    int Accept() const;
+
+    //! stop blocking Accept() and Receive*() calls on other threads, without releasing the descriptor yet
+    void Shutdown() const;
+
+    //! tell the peer nothing more will be sent, receiving keeps working
+    void ShutdownSend() const;
+
+    void Close();
+
+    [[nodiscard]] bool is_open() const { return fd_ >= 0; }
+
+    bool Send(const void* data, size_t num_bytes) const;
+
+    //! send 'num_bytes' with 'descriptor' attached to the first byte
+    bool SendWithDescriptor(const void* data, size_t num_bytes, int descriptor) const;
+
+    //! false once the peer closed the connection or it failed
+    bool Receive(void* data, size_t num_bytes) const;
+
+    //! like Receive(), 'descriptor' is set to a descriptor that came along with the bytes or -1. The caller owns it
+    bool ReceiveWithDescriptor(void* data, size_t num_bytes, int& descriptor) const;
+
+  private:
+    int fd_ = -1;
+};
+
+//! $XDG_RUNTIME_DIR/spirv-analyzerd.sock, which only the user can reach, or /tmp/spirv-analyzerd.sock without it
+std::string SpirVAnalyzerDefaultSocketPath();
+
+#endif // SPIRV_PARSING_ANALYZER_DAEMON_SPIRV_ANALYZER_SOCKET_H
@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "spirv_analyzer_protocol.h"
+#include "spirv_analyzer_socket.h"
+#include "spirv_buffer_reference_file.h"
+#include "spirv_file.h"
+#include "spirv_parsing_util.h"
+#include "spirv_result_ring.h"
+#include "vertex_input_position_analyzer.h"
+
+namespace {
+
+// larger modules are expected to come in shared memory, this only stops a broken client from exhausting memory
+constexpr uint64_t kMaxInlineBytes = 1ull << 30;
+
+// a client only has this many requests, and inline modules of this size, queued or unanswered before the daemon stops
+// reading from it. Back-pressure then reaches the client through its socket instead of growing the daemon
+constexpr size_t kMaxInFlightRequests = 64;
+constexpr uint64_t kMaxInFlightInlineBytes = 1ull << 30;
+
+// the listening socket, so a signal can stop the accept loop
+const SpirVAnalyzerSocket* g_listener = nullptr;
+
+void HandleStopSignal(int) {
+    if (g_listener) {
+        g_listener->Shutdown();
+    }
+}
+
+// bytes a request holds in the daemon until it is answered
+uint64_t InlineBytes(const SpirVAnalyzerRequest& request) {
+    return (request.flags & kSpirVAnalyzerFlagSharedMemory) ? 0 : request.num_bytes;
+}
+
+// one client, shared by its reader and writer threads and every job still in flight. The socket closes with the last
+// of them. Workers only queue their answers here, a client that doesn't read them only ever blocks its own writer
+class Connection {
+  public:
+    explicit Connection(int fd) : socket(fd) {}
+
+    // reader: wait until another request of 'num_bytes' inline bytes fits in flight, false once the client is gone
+    bool Admit(uint64_t num_bytes) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [&] {
+            return broken_ || in_flight_ == 0 ||
+                   (in_flight_ < kMaxInFlightRequests && in_flight_bytes_ + num_bytes <= kMaxInFlightInlineBytes);
+        });
+        if (broken_) {
+            return false;
+        }
+        in_flight_++;
+        in_flight_bytes_ += num_bytes;
+        return true;
+    }
+
+    // reader: an admitted request that never made it to a worker
+    void Cancel(uint64_t num_bytes) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Retire(num_bytes);
+        }
+        condition_.notify_all();
+    }
+
+    // worker: hand the answer of a request to the writer, workers finish in any order
+    void Respond(const SpirVAnalyzerResponse& response, const void* payload, uint64_t request_bytes) {
+        const uint8_t* payload_bytes = static_cast<const uint8_t*>(payload);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            outbox_.push_back({response,
+                               std::vector<uint8_t>(payload_bytes, payload_bytes + response.payload_bytes),
+                               request_bytes});
+        }
+        condition_.notify_all();
+    }
+
+    // reader: the client sends nothing more, the writer stops once the last admitted request is answered
+    void FinishReading() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            reading_finished_ = true;
+        }
+        condition_.notify_all();
+    }
+
+    // writer: send the answers one at a time, so they never interleave
+    void WriteResponses() {
+        for (;;) {
+            PendingResponse pending;
+            bool broken = false;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(lock, [this] { return !outbox_.empty() || (reading_finished_ && in_flight_ == 0); });
+                if (outbox_.empty()) {
+                    return;
+                }
+                pending = std::move(outbox_.front());
+                outbox_.pop_front();
+                broken = broken_;
+            }
+
+            // a client that went away just loses its answers
+            const bool sent = !broken && socket.Send(&pending.response, sizeof(pending.response)) &&
+                              (pending.payload.empty() || socket.Send(pending.payload.data(), pending.payload.size()));
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                broken_ = !sent;
+                Retire(pending.request_bytes);
+            }
+            condition_.notify_all();
+        }
+    }
+
+    SpirVAnalyzerSocket socket;
+
+  private:
+    struct PendingResponse {
+        SpirVAnalyzerResponse response;
+        std::vector<uint8_t> payload;
+        uint64_t request_bytes = 0;
+    };
+
+    void Retire(uint64_t num_bytes) {
+        in_flight_--;
+        in_flight_bytes_ -= num_bytes;
+    }
+
+    std::mutex mutex_;
+    // woken for the reader, the writer and on every change of what is in flight
+    std::condition_variable condition_;
+    // answered but not sent yet, never more than in flight
+    std::deque<PendingResponse> outbox_;
+    size_t in_flight_ = 0;
+    uint64_t in_flight_bytes_ = 0;
+    bool reading_finished_ = false;
+    bool broken_ = false;
+};
+
+struct Job {
+    std::shared_ptr<Connection> connection;
+    SpirVAnalyzerRequest request;
+    // the module of an inline request
+    std::vector<uint32_t> words;
+    // the module of a shared request, closed by the worker
+    int descriptor = -1;
+};
+
+class JobQueue {
+  public:
+    void Push(Job&& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        condition_.notify_one();
+    }
+
+    // false once the queue was stopped
+    bool Pop(Job& job) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return stopped_ || !jobs_.empty(); });
+        if (stopped_) {
+            return false;
+        }
+        job = std::move(jobs_.front());
+        jobs_.pop_front();
+        return true;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        condition_.notify_all();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<Job> jobs_;
+    bool stopped_ = false;
+};
+
+// everything a worker keeps between requests, so a warm daemon analyzes without rebuilding its tables
+class Worker {
+  public:
+    Worker() {
+        for (SpirVParsingUtil* parsing_util : {&bda_native_, &bda_reflect_}) {
+            parsing_util->SetRetentionPolicy(SpirVRetentionPolicy::HighWaterMark());
+        }
+        vertex_.SetRetentionPolicy(SpirVRetentionPolicy::HighWaterMark());
+    }
+
+    void Run(JobQueue& queue) {
+        Job job;
+        while (queue.Pop(job)) {
+            Process(job);
+            // drop the connection now rather than when the next job arrives
+            job = Job();
+        }
+    }
+
+  private:
+    void Process(Job& job) {
+        SpirVAnalyzerResponse response;
+        response.request_id = job.request.request_id;
+        const bool shared = (job.request.flags & kSpirVAnalyzerFlagSharedMemory) != 0;
+
+        const void* payload = nullptr;
+        switch (static_cast<SpirVAnalyzerPass>(job.request.pass)) {
+            case SpirVAnalyzerPass::BDA_ADDRESS:
+            case SpirVAnalyzerPass::BDA_ADDRESS_REFLECT: {
+                SpirVParsingUtil& parsing_util =
+                    job.request.pass == static_cast<uint32_t>(SpirVAnalyzerPass::BDA_ADDRESS) ? bda_native_
+                                                                                             : bda_reflect_;
+                bool success = false;
+                if (shared) {
+                    // the pass maps and checks the memfd itself and analyzes the mapping in place. The answer needs
+                    // the access-chain names, which WriteBufferReferences() still has, so the records are dropped
+                    SpirVResultRing<SpirVParsingUtil::BufferReferenceRecord> records(record_storage_.data(),
+                                                                                     record_storage_.size());
+                    success = parsing_util.FindBufferReferences(job.descriptor, job.request.request_id, records);
+                } else {
+                    success = parsing_util.FindBufferReferences(job.words.data(),
+                                                                static_cast<size_t>(job.request.num_bytes));
+                }
+                LogDiagnostics(job.request.request_id, parsing_util.diagnostics());
+                if (success) {
+                    reference_writer_.Clear();
+                    parsing_util.WriteBufferReferences(reference_writer_);
+                    reference_writer_.Finish(references_);
+                    payload = references_.data();
+                    response.payload_bytes = references_.size();
+                } else {
+                    response.status = static_cast<uint32_t>(IsUnmappable(parsing_util.diagnostics())
+                                                                ? SpirVAnalyzerStatus::BAD_REQUEST
+                                                                : SpirVAnalyzerStatus::ANALYSIS_FAILED);
+                }
+                break;
+            }
+            case SpirVAnalyzerPass::VERTEX_INPUT_POSITION: {
+                const uint32_t* spirv_code = job.words.data();
+                size_t spirv_num_bytes = static_cast<size_t>(job.request.num_bytes);
+                if (shared) {
+                    if (!shared_module_.OpenDescriptor(job.descriptor)) {
+                        response.status = static_cast<uint32_t>(SpirVAnalyzerStatus::BAD_REQUEST);
+                        break;
+                    }
+                    spirv_code = shared_module_.data();
+                    spirv_num_bytes = shared_module_.size_bytes();
+                }
+
+                // the status says why a module has no Position, so it is sent for failures as well
+                if (!vertex_.Analyze(spirv_code, spirv_num_bytes)) {
+                    response.status = static_cast<uint32_t>(SpirVAnalyzerStatus::ANALYSIS_FAILED);
+                }
+                const VertexInputPositionAnalyzer::Result& result = vertex_.GetResult();
+                vertex_payload_.assign(1, static_cast<uint32_t>(result.status));
+                vertex_payload_.insert(vertex_payload_.end(), result.locations.begin(), result.locations.end());
+                payload = vertex_payload_.data();
+                response.payload_bytes = vertex_payload_.size() * sizeof(uint32_t);
+                shared_module_.Close();
+                break;
+            }
+            default:
+                response.status = static_cast<uint32_t>(SpirVAnalyzerStatus::BAD_REQUEST);
+                break;
+        }
+        if (job.descriptor >= 0) {
+            close(job.descriptor);
+        }
+
+        job.connection->Respond(response, payload, InlineBytes(job.request));
+    }
+
+    // one block of lines per request, tagged with its request_id, so the diagnostics of requests finishing at the same
+    // time on other workers neither interleave with these nor lose which module they belong to
+    static void LogDiagnostics(uint64_t request_id, const SpirVDiagnostics& diagnostics) {
+        char message[256];
+        flockfile(stderr);
+        for (const SpirVDiagnostic& diagnostic : diagnostics.entries()) {
+            SpirVDiagnostics::FormatMessage(diagnostic, message, sizeof(message));
+            fprintf(stderr, "request %llu: %s: %s\n", static_cast<unsigned long long>(request_id),
+                    SpirVDiagnostics::SeverityName(diagnostic.severity), message);
+        }
+        funlockfile(stderr);
+    }
+
+    static bool IsUnmappable(const SpirVDiagnostics& diagnostics) {
+        return std::any_of(diagnostics.entries().begin(), diagnostics.entries().end(), [](const SpirVDiagnostic& entry) {
+            return entry.code == SpirVDiagnosticCode::UNMAPPABLE_MODULE;
+        });
+    }
+
+    SpirVParsingUtil bda_native_{SpirVParsingUtil::LayoutSource::NATIVE};
+    SpirVParsingUtil bda_reflect_{SpirVParsingUtil::LayoutSource::SPIRV_REFLECT};
+    VertexInputPositionAnalyzer vertex_;
+    // shared modules of the vertex pass, the BDA pass maps its own
+    SpirVFile shared_module_;
+    std::array<SpirVParsingUtil::BufferReferenceRecord, 64> record_storage_{};
+    SpirVBufferReferenceFileWriter reference_writer_;
+    std::vector<uint8_t> references_;
+    std::vector<uint32_t> vertex_payload_;
+};
+
+// queue the requests of one client until it disconnects or stops reading its answers
+void QueueRequests(const std::shared_ptr<Connection>& connection, JobQueue& queue) {
+    for (;;) {
+        Job job;
+        if (!connection->socket.ReceiveWithDescriptor(&job.request, sizeof(job.request), job.descriptor)) {
+            return;
+        }
+
+        // without a valid header the start of the next request can't be found, so the connection is dropped
+        const bool shared = (job.request.flags & kSpirVAnalyzerFlagSharedMemory) != 0;
+        bool valid = job.request.magic == kSpirVAnalyzerMagic &&
+                     job.request.version == kSpirVAnalyzerProtocolVersion &&
+                     (shared || job.request.num_bytes <= kMaxInlineBytes) &&
+                     connection->Admit(InlineBytes(job.request));
+        if (valid && !shared) {
+            job.words.resize(static_cast<size_t>((job.request.num_bytes + 3) / sizeof(uint32_t)));
+            valid = connection->socket.Receive(job.words.data(), static_cast<size_t>(job.request.num_bytes));
+            if (!valid) {
+                connection->Cancel(InlineBytes(job.request));
+            }
+        }
+        if (!valid) {
+            if (job.descriptor >= 0) {
+                close(job.descriptor);
+            }
+            return;
+        }
+
+        job.connection = connection;
+        queue.Push(std::move(job));
+    }
+}
+
+// the workers answer the requests of one client and its writer sends the answers, until the last one is out
+void ReadRequests(const std::shared_ptr<Connection>& connection, const std::shared_ptr<JobQueue>& queue) {
+    std::thread writer(&Connection::WriteResponses, connection.get());
+    QueueRequests(connection, *queue);
+    connection->FinishReading();
+    writer.join();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string socket_path = SpirVAnalyzerDefaultSocketPath();
+    // --jobs 0 (the default) uses every hardware thread
+    size_t num_jobs = 0;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+            num_jobs = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            std::cout << "Usage:\n\t" << argv[0] << " [--socket PATH] [--jobs N]\n";
+            return EXIT_FAILURE;
+        }
+    }
+    if (num_jobs == 0) {
+        num_jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    SpirVAnalyzerSocket listener;
+    if (!listener.Listen(socket_path.c_str())) {
+        std::cout << "ERROR: Unable to listen on " << socket_path << ": " << strerror(errno) << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // SIGINT/SIGTERM end the accept loop, the socket file is removed on the way out
+    g_listener = &listener;
+    struct sigaction stop_action = {};
+    stop_action.sa_handler = HandleStopSignal;
+    sigaction(SIGINT, &stop_action, nullptr);
+    sigaction(SIGTERM, &stop_action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    // shared with the reader threads, which may still be running when main returns
+    auto queue = std::make_shared<JobQueue>();
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> worker_threads;
+    for (size_t i = 0; i < num_jobs; i++) {
+        workers.push_back(std::make_unique<Worker>());
+        worker_threads.emplace_back(&Worker::Run, workers.back().get(), std::ref(*queue));
+    }
+
+    std::cout << "Listening on " << socket_path << " with " << num_jobs << " workers" << std::endl;
+
+    for (;;) {
+        const int client = listener.Accept();
+        if (client < 0) {
+            break;
+        }
+        // readers block in recv until their client goes away and writers until its answers are out, neither is waited
+        // for on shutdown
+        std::thread(ReadRequests, std::make_shared<Connection>(client), queue).detach();
+    }
+
+    queue->Stop();
+    for (std::thread& worker_thread : worker_threads) {
+        worker_thread.join();
+    }
+    unlink(socket_path.c_str());
+    return 0;
+}
@@ -1,42 +1,137 @@
 #include <iostream>
 #include <filesystem>
 
-#include <chrono>
+#include <cstdlib>
+#include <memory>
 #include <optional>
+#include <string>
+#include <vector>
 
+#include "spirv_batch.h"
+#include "spirv_batch_runner.h"
+#include "spirv_buffer_reference_file.h"
+#include "spirv_diagnostics.h"
+#include "spirv_file.h"
+#include "spirv_ndjson_writer.h"
 #include "spirv_parsing_util.h"
+#include "spirv_result_cache.h"
 
 int main(int argc, char** argv) {
-    if (argc < 2) {
-        std::cout << "Usage:\n\t" << argv[0] << " input.spv\n";
-        return EXIT_FAILURE;
-    } else if (!std::filesystem::exists(argv[1])) {
-        std::cout << "ERROR: " << argv[1] << " Does not exists\n";
-        return EXIT_FAILURE;
+    // --reflect takes struct layouts from SPIRV-Reflect instead of the built-in single-parse layout
+    auto layout_source = SpirVParsingUtil::LayoutSource::NATIVE;
+    // --jobs 0 (the default) uses every hardware thread
+    size_t num_jobs = 0;
+    // --cache DIR answers modules that were analyzed before from DIR and adds the others to it
+    std::string cache_directory;
+    // --ndjson prints one JSON record per diagnostic and buffer-reference instead of the text report, the summary goes
+    // to stderr
+    bool ndjson = false;
+    // --binary-output FILE writes the buffer-references of a single module to FILE in the flat format of
+    // spirv_buffer_reference_file.h instead of printing them, diagnostics go to stderr
+    std::string binary_output_path;
+    // --severity info|warning|error only reports diagnostics of at least that severity
+    auto minimum_severity = SpirVDiagnosticSeverity::INFO;
+    SpirVBatch batch;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--reflect") {
+            layout_source = SpirVParsingUtil::LayoutSource::SPIRV_REFLECT;
+        } else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+            num_jobs = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--cache" && i + 1 < argc) {
+            cache_directory = argv[++i];
+        } else if (arg == "--ndjson") {
+            ndjson = true;
+        } else if (arg == "--binary-output" && i + 1 < argc) {
+            binary_output_path = argv[++i];
+        } else if (arg == "--severity" && i + 1 < argc) {
+            if (!SpirVDiagnostics::ParseSeverity(argv[++i], minimum_severity)) {
+                std::cout << "ERROR: Unknown severity " << argv[i] << ", expected info, warning or error\n";
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--manifest" && i + 1 < argc) {
+            if (!batch.AddManifest(argv[++i])) {
+                std::cout << "ERROR: Unable to read the manifest " << argv[i] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else if (!batch.AddInput(arg)) {
+            std::cout << "ERROR: " << arg << " Does not exists\n";
+            return EXIT_FAILURE;
+        }
     }
 
-    FILE* fp = fopen(argv[1], "rb");
-    if (!fp) {
-        std::cout << "ERROR: Unable to open the input file " << argv[1] << "\n";
+    const bool binary = !binary_output_path.empty();
+    if (batch.files().empty() || (binary && (batch.is_batch() || ndjson))) {
+        std::cout << "Usage:\n\t" << argv[0]
+                  << " [--reflect] [--ndjson | --binary-output FILE] [--severity LEVEL] [--cache DIR] input.spv\n"
+                  << "\t" << argv[0]
+                  << " [--reflect] [--ndjson] [--severity LEVEL] [--cache DIR] [--jobs N] [--manifest list.txt]"
+                     " (input.spv | directory)...\n";
         return EXIT_FAILURE;
     }
 
-    std::vector<uint32_t> spirv;
-    const int buf_size = 1024;
-    uint32_t buf[buf_size];
-    while (size_t len = fread(buf, sizeof(uint32_t), buf_size, fp)) {
-        spirv.insert(spirv.end(), buf, buf + len);
+    // the layout source is part of the key, both are meant to agree but a cache must not paper over a difference
+    std::optional<SpirVResultCache> cache;
+    if (!cache_directory.empty()) {
+        const bool reflect = layout_source == SpirVParsingUtil::LayoutSource::SPIRV_REFLECT;
+        cache.emplace(cache_directory,
+                      "bda_address/" + std::to_string(SpirVParsingUtil::kResultVersion) +
+                          (reflect ? "/reflect" : "/native") + (binary ? "/binary" : ndjson ? "/ndjson" : "/text") +
+                          "/" +
+                          SpirVDiagnostics::SeverityName(minimum_severity));
     }
-    fclose(fp);
 
-    auto start_time = std::chrono::high_resolution_clock::now();
+    // one analyzer per worker, reused for every module the worker picks up so its containers are reused
+    SpirVBatchRunner::Options options;
+    options.num_jobs = num_jobs;
+    options.ndjson = ndjson;
+    options.cache = cache ? &*cache : nullptr;
 
-    SpirVParsingUtil parsing_util;
-    parsing_util.ParseBufferReferences(spirv.data(), spirv.size() * sizeof(uint32_t));
+    std::unique_ptr<FILE, int (*)(FILE*)> binary_output(nullptr, fclose);
+    if (binary) {
+        binary_output.reset(fopen(binary_output_path.c_str(), "wb"));
+        if (!binary_output) {
+            std::cout << "ERROR: Unable to create " << binary_output_path << "\n";
+            return EXIT_FAILURE;
+        }
+        options.output = binary_output.get();
+    }
+    SpirVBatchRunner runner(batch, options);
+    std::vector<std::unique_ptr<SpirVParsingUtil>> parsing_utils(runner.num_workers());
+    for (auto& parsing_util : parsing_utils) {
+        parsing_util = std::make_unique<SpirVParsingUtil>(layout_source);
+        parsing_util->SetMinimumSeverity(minimum_severity);
+        if (batch.is_batch()) {
+            // a single huge module must not pin its tables for the rest of the batch
+            parsing_util->SetRetentionPolicy(SpirVRetentionPolicy::HighWaterMark());
+        }
+    }
 
-    auto end_time = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double, std::milli> duration = end_time - start_time;
-    std::cout << "Time = " << duration.count() << " ms\n";
+    // only used with --binary-output, which takes a single module
+    SpirVBufferReferenceFileWriter reference_writer;
+    std::vector<uint8_t> references;
 
-    return 0;
-}
\ No newline at end of file
+    // run the pass and write its report to 'output', the text report, the NDJSON records or the flat file
+    return runner.Run([&](size_t worker_index, SpirVNdjsonWriter& writer, const SpirVFile& spirv, FILE* output) {
+        SpirVParsingUtil& parsing_util = *parsing_utils[worker_index];
+        if (binary) {
+            const bool success = parsing_util.FindBufferReferences(spirv.data(), spirv.size_bytes());
+            parsing_util.diagnostics().Print(stderr);
+            if (success) {
+                reference_writer.Clear();
+                parsing_util.WriteBufferReferences(reference_writer);
+                reference_writer.Finish(references);
+                fwrite(references.data(), 1, references.size(), output);
+            }
+            return success;
+        }
+        if (!ndjson) {
+            parsing_util.SetOutput(output);
+            return parsing_util.ParseBufferReferences(spirv.data(), spirv.size_bytes());
+        }
+        const bool success = parsing_util.FindBufferReferences(spirv.data(), spirv.size_bytes());
+        parsing_util.diagnostics().Emit(writer);
+        parsing_util.EmitBufferReferences(writer);
+        return success;
+    });
+}
@@ -0,0 +1,195 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_buffer_reference_file.h"
+
+#include <cstring>
+
+namespace
+{
+uint64_t AlignTo8(uint64_t offset)
+{
+    return (offset + 7) & ~uint64_t(7);
+}
+
+// [offset, offset + num_bytes) lies inside the first 'total_bytes', without overflowing
+bool InBounds(uint64_t offset, uint64_t num_bytes, uint64_t total_bytes)
+{
+    return offset <= total_bytes && num_bytes <= total_bytes - offset;
+}
+}  // namespace
+
+void SpirVBufferReferenceFileWriter::Clear()
+{
+    records_.clear();
+    chain_.clear();
+    strings_.clear();
+    string_offsets_.clear();
+}
+
+uint32_t SpirVBufferReferenceFileWriter::Intern(const std::string& name)
+{
+    const auto [it, inserted] = string_offsets_.try_emplace(name, static_cast<uint32_t>(strings_.size()));
+    if (inserted)
+    {
+        strings_.append(name.c_str(), name.size() + 1);
+    }
+    return it->second;
+}
+
+void SpirVBufferReferenceFileWriter::Add(const SpirVParsingUtil::BufferReferenceInfo& info,
+                                         const std::vector<std::string>&              chain_names)
+{
+    SpirVBufferReferenceRecord record;
+    record.source        = static_cast<uint32_t>(info.source);
+    record.set           = info.set;
+    record.binding       = info.binding;
+    record.buffer_offset = info.buffer_offset;
+    record.array_stride  = info.array_stride;
+    record.chain_first   = static_cast<uint32_t>(chain_.size());
+    record.chain_length  = static_cast<uint32_t>(chain_names.size());
+    records_.push_back(record);
+
+    for (const std::string& name : chain_names)
+    {
+        chain_.push_back(Intern(name));
+    }
+}
+
+void SpirVBufferReferenceFileWriter::Finish(std::vector<uint8_t>& output) const
+{
+    SpirVBufferReferenceFileHeader header;
+    header.record_bytes      = sizeof(SpirVBufferReferenceRecord);
+    header.num_records       = static_cast<uint32_t>(records_.size());
+    header.num_chain_entries = static_cast<uint32_t>(chain_.size());
+    header.records_offset    = AlignTo8(sizeof(header));
+    header.chain_offset      = AlignTo8(header.records_offset + records_.size() * sizeof(SpirVBufferReferenceRecord));
+    header.strings_offset    = AlignTo8(header.chain_offset + chain_.size() * sizeof(uint32_t));
+    header.strings_bytes     = strings_.size();
+    header.total_bytes       = header.strings_offset + header.strings_bytes;
+
+    // padding between the sections is zeroed, so equal results give equal files
+    output.assign(static_cast<size_t>(header.total_bytes), 0);
+    memcpy(output.data(), &header, sizeof(header));
+    if (!records_.empty())
+    {
+        memcpy(output.data() + header.records_offset,
+               records_.data(),
+               records_.size() * sizeof(SpirVBufferReferenceRecord));
+    }
+    if (!chain_.empty())
+    {
+        memcpy(output.data() + header.chain_offset, chain_.data(), chain_.size() * sizeof(uint32_t));
+    }
+    if (!strings_.empty())
+    {
+        memcpy(output.data() + header.strings_offset, strings_.data(), strings_.size());
+    }
+}
+
+bool SpirVBufferReferenceFileReader::Open(const void* data, size_t num_bytes)
+{
+    data_ = nullptr;
+    header_ = SpirVBufferReferenceFileHeader();
+    if (data == nullptr || num_bytes < sizeof(SpirVBufferReferenceFileHeader))
+    {
+        return false;
+    }
+
+    SpirVBufferReferenceFileHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != kSpirVBufferReferenceFileMagic || header.version != kSpirVBufferReferenceFileVersion ||
+        header.header_bytes != sizeof(SpirVBufferReferenceFileHeader) ||
+        header.record_bytes != sizeof(SpirVBufferReferenceRecord) || header.total_bytes > num_bytes)
+    {
+        return false;
+    }
+
+    const uint64_t total_bytes = header.total_bytes;
+    if (!InBounds(header.records_offset, uint64_t(header.num_records) * sizeof(SpirVBufferReferenceRecord), total_bytes) ||
+        !InBounds(header.chain_offset, uint64_t(header.num_chain_entries) * sizeof(uint32_t), total_bytes) ||
+        !InBounds(header.strings_offset, header.strings_bytes, total_bytes))
+    {
+        return false;
+    }
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+
+    // every name ends inside the string table, since its last byte is a terminator
+    if (header.num_chain_entries > 0 &&
+        (header.strings_bytes == 0 || bytes[header.strings_offset + header.strings_bytes - 1] != '\0'))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < header.num_chain_entries; i++)
+    {
+        uint32_t string_offset;
+        memcpy(&string_offset, bytes + header.chain_offset + i * sizeof(uint32_t), sizeof(string_offset));
+        if (string_offset >= header.strings_bytes)
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header.num_records; i++)
+    {
+        SpirVBufferReferenceRecord record;
+        memcpy(&record, bytes + header.records_offset + i * sizeof(record), sizeof(record));
+        if (uint64_t(record.chain_first) + record.chain_length > header.num_chain_entries)
+        {
+            return false;
+        }
+    }
+
+    data_   = bytes;
+    header_ = header;
+    return true;
+}
+
+SpirVBufferReferenceRecord SpirVBufferReferenceFileReader::GetRecord(size_t index) const
+{
+    // copied out, a mapping or socket buffer doesn't have to be aligned for the record
+    SpirVBufferReferenceRecord record;
+    memcpy(&record, data_ + header_.records_offset + index * sizeof(record), sizeof(record));
+    return record;
+}
+
+SpirVParsingUtil::BufferReferenceInfo SpirVBufferReferenceFileReader::GetInfo(size_t index) const
+{
+    const SpirVBufferReferenceRecord      record = GetRecord(index);
+    SpirVParsingUtil::BufferReferenceInfo info;
+    info.source        = static_cast<SpirVParsingUtil::BufferReferenceLocation>(record.source);
+    info.set           = record.set;
+    info.binding       = record.binding;
+    info.buffer_offset = record.buffer_offset;
+    info.array_stride  = record.array_stride;
+    return info;
+}
+
+const char* SpirVBufferReferenceFileReader::GetChainName(size_t index, uint32_t element) const
+{
+    const SpirVBufferReferenceRecord record = GetRecord(index);
+    uint32_t                         string_offset;
+    memcpy(&string_offset,
+           data_ + header_.chain_offset + (uint64_t(record.chain_first) + element) * sizeof(uint32_t),
+           sizeof(string_offset));
+    return reinterpret_cast<const char*>(data_ + header_.strings_offset + string_offset);
+}
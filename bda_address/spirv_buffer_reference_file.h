@@ -0,0 +1,129 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_BDA_ADDRESS_SPIRV_BUFFER_REFERENCE_FILE_H
+#define SPIRV_PARSING_BDA_ADDRESS_SPIRV_BUFFER_REFERENCE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "spirv_parsing_util.h"
+
+// A flat, versioned binary form of the buffer-references of one module, including the access-chain names.
+//
+// The file can be memory-mapped and read in place, no parsing or allocation is needed to get at a record:
+//
+//   SpirVBufferReferenceFileHeader
+//   SpirVBufferReferenceRecord[num_records]        at records_offset
+//   uint32_t[num_chain_entries]                    at chain_offset, string-table offsets of the access-chain names
+//   char[strings_bytes]                            at strings_offset, NUL-terminated names, each stored once
+//
+// A record's access-chain is chain_length entries starting at chain_first. Sections start 8-byte aligned and all
+// values are in the byte order of the writer.
+
+constexpr uint32_t kSpirVBufferReferenceFileMagic   = 0x52425053;  // "SPBR"
+constexpr uint32_t kSpirVBufferReferenceFileVersion = 1;
+
+struct SpirVBufferReferenceFileHeader
+{
+    uint32_t magic        = kSpirVBufferReferenceFileMagic;
+    uint32_t version      = kSpirVBufferReferenceFileVersion;
+    uint32_t header_bytes = sizeof(SpirVBufferReferenceFileHeader);
+    uint32_t record_bytes = 0;
+
+    //! size of the whole file, readers reject anything shorter
+    uint64_t total_bytes = 0;
+
+    uint32_t num_records       = 0;
+    uint32_t num_chain_entries = 0;
+    uint64_t records_offset    = 0;
+    uint64_t chain_offset      = 0;
+    uint64_t strings_offset    = 0;
+    uint64_t strings_bytes     = 0;
+};
+
+struct SpirVBufferReferenceRecord
+{
+    //! SpirVParsingUtil::BufferReferenceLocation
+    uint32_t source        = 0;
+    uint32_t set           = 0;
+    uint32_t binding       = 0;
+    uint32_t buffer_offset = 0;
+    uint32_t array_stride  = 0;
+    uint32_t chain_first   = 0;
+    uint32_t chain_length  = 0;
+    uint32_t reserved      = 0;
+};
+
+static_assert(sizeof(SpirVBufferReferenceFileHeader) == 64, "the header is part of the file format");
+static_assert(sizeof(SpirVBufferReferenceRecord) == 32, "the records are part of the file format");
+
+// SpirVBufferReferenceFileWriter collects buffer-references and lays them out in the file format. Clear() keeps the
+// memory, so one writer can serialize a whole batch.
+class SpirVBufferReferenceFileWriter
+{
+  public:
+    void Clear();
+
+    void Add(const SpirVParsingUtil::BufferReferenceInfo& info, const std::vector<std::string>& chain_names);
+
+    //! the complete file, 'output' is overwritten
+    void Finish(std::vector<uint8_t>& output) const;
+
+  private:
+    uint32_t Intern(const std::string& name);
+
+    std::vector<SpirVBufferReferenceRecord>   records_{};
+    std::vector<uint32_t>                     chain_{};
+    std::string                               strings_{};
+    std::unordered_map<std::string, uint32_t> string_offsets_{};
+};
+
+// SpirVBufferReferenceFileReader reads a file in place, e.g. straight from a mapping. The bytes must stay valid while
+// the reader is used.
+class SpirVBufferReferenceFileReader
+{
+  public:
+    //! false if the bytes are not a complete file of this version, every offset is checked here so the accessors
+    //! below can't read out of bounds
+    bool Open(const void* data, size_t num_bytes);
+
+    [[nodiscard]] size_t size() const { return header_.num_records; }
+
+    [[nodiscard]] SpirVParsingUtil::BufferReferenceInfo GetInfo(size_t index) const;
+
+    [[nodiscard]] uint32_t GetChainLength(size_t index) const { return GetRecord(index).chain_length; }
+
+    //! name of an element of the access-chain, the root first
+    [[nodiscard]] const char* GetChainName(size_t index, uint32_t element) const;
+
+  private:
+    [[nodiscard]] SpirVBufferReferenceRecord GetRecord(size_t index) const;
+
+    const uint8_t*                 data_ = nullptr;
+    SpirVBufferReferenceFileHeader header_{};
+};
+
+#endif // SPIRV_PARSING_BDA_ADDRESS_SPIRV_BUFFER_REFERENCE_FILE_H
@@ -23,8 +23,10 @@
 #define SPV_ENABLE_UTILITY_CODE
 
 #include "spirv_parsing_util.h"
-#include "helper.h"
+#include "spirv_buffer_reference_file.h"
+#include "spirv_ndjson_writer.h"
 #include "spirv_reflect.h"
+#include "spirv_scanner.h"
 #include <functional>
 #include <optional>
 #include <cassert>
@@ -37,109 +39,113 @@ bool operator<(const SpirVParsingUtil::BufferReferenceInfo& lhs, const SpirVPars
            std::make_tuple(rhs.source, rhs.set, rhs.binding, rhs.buffer_offset, rhs.array_stride);
 }
 
-// Instruction represents a single Spv::Op instruction.
-class SpirVParsingUtil::Instruction
+namespace
 {
-  public:
-    explicit Instruction(const uint32_t* spirv)
+// operand words the pass reads without further checks, for the opcodes of the walk over the module
+uint32_t GetMinimumOperands(uint32_t opcode)
+{
+    switch (opcode)
     {
-        assert(spirv != nullptr);
-
-        words_ = spirv;
-
-        const bool has_result = OpcodeHasResult(opcode());
-        if (OpcodeHasType(opcode()))
-        {
-            type_id_index_ = 1;
-            operand_index_++;
-            if (has_result)
-            {
-                result_id_index_ = 2;
-                operand_index_++;
-            }
-        }
-        else if (has_result)
-        {
-            result_id_index_ = 1;
-            operand_index_++;
-        }
+        case spv::OpLoad:
+        case spv::OpVariable:
+            return 1;
+        case spv::OpStore:
+        case spv::OpDecorate:
+        case spv::OpName:
+            return 2;
+        case spv::OpMemberDecorate:
+        case spv::OpMemberName:
+            return 3;
+        default:
+            return 0;
     }
+}
+}  // namespace
 
-    //! the word used to define the Instruction
-    [[nodiscard]] uint32_t word(uint32_t index) const { return words_[index]; }
-
-    //! skips pass any optional Result or Result Type word
-    [[nodiscard]] uint32_t operand(uint32_t index) const { return words_[operand_index_ + index]; }
-
-    //! number of words used as operands
-    [[nodiscard]] uint32_t num_operands() const { return length() - operand_index_; }
-
-    //! length of instruction in words
-    [[nodiscard]] uint32_t length() const { return words_[0] >> 16; }
-
-    //! the instruction's op-code
-    [[nodiscard]] uint32_t opcode() const { return words_[0] & 0x0ffffu; }
-
-    //! operand id, return 0 if no result
-    [[nodiscard]] uint32_t resultId() const { return (result_id_index_ == 0) ? 0 : words_[result_id_index_]; }
-
-    //! operand id, return 0 if no type
-    [[nodiscard]] uint32_t typeId() const { return (type_id_index_ == 0) ? 0 : words_[type_id_index_]; }
+SpirVParsingUtil::Instruction SpirVParsingUtil::FindDef(uint32_t id) const
+{
+    return instructions_.FindDef(id);
+}
 
-    //! constant values can safely be returned as uint32_t
-    [[nodiscard]] uint32_t constant_value() const
+void SpirVParsingUtil::FindVariableStores(uint32_t variable_id, std::vector<Instruction>& objects) const
+{
+    // a variable can be written multiple times, return the objects of all stores seen so far
+    uint32_t record = variable_id < store_heads_.size() ? store_heads_[variable_id] : 0;
+    while (record != 0)
     {
-        assert(opcode() == spv::OpConstant);
-        return words_[3];
+        const StoreRecord& store = store_records_[record - 1];
+        if (Instruction object_insn = FindDef(instructions_[store.instruction_index].operand(1)))
+        {
+            objects.push_back(object_insn);
+        }
+        record = store.previous;
     }
+}
 
-  private:
-    // store minimal extra data
-    uint32_t result_id_index_ = 0;
-    uint32_t type_id_index_   = 0;
-    uint32_t operand_index_   = 1;
-
-    const uint32_t* words_ = nullptr;
-};
+size_t SpirVParsingUtil::used_bytes() const
+{
+    return instructions_.used_bytes() + decorations_.used_bytes() + store_heads_.size() * sizeof(uint32_t) +
+           store_records_.size() * sizeof(StoreRecord) + names_.size() * sizeof(const char*) +
+           member_names_.used_bytes() + variable_visits_.size() * sizeof(uint32_t) +
+           block_variables_.size() * sizeof(Instruction);
+}
 
-//// This is the LUT for hoping around instruction from the result ID
-// std::unordered_map<uint32_t, const SpirVInstruction*> definitions;
+void SpirVParsingUtil::ReleaseModule()
+{
+    released_used_bytes_ = used_bytes();
+    module_code_         = nullptr;
+    module_num_bytes_    = 0;
+    instructions_.Clear();
+    names_.clear();
+    member_names_.Clear();
+    block_variables_.clear();
+    pending_paths_.clear();
+    stored_objects_.clear();
+}
 
-const SpirVParsingUtil::Instruction* SpirVParsingUtil::FindDef(uint32_t id)
+size_t SpirVParsingUtil::retained_bytes() const
 {
-    auto it = definitions_.find(id);
-    if (it == definitions_.end())
-    {
-        return nullptr;
-    }
-    return it->second;
+    return instructions_.retained_bytes() + decorations_.retained_bytes() +
+           store_heads_.capacity() * sizeof(uint32_t) + store_records_.capacity() * sizeof(StoreRecord) +
+           names_.capacity() * sizeof(const char*) + member_names_.retained_bytes() +
+           variable_visits_.capacity() * sizeof(uint32_t) + block_variables_.capacity() * sizeof(Instruction);
 }
 
-const SpirVParsingUtil::Instruction* SpirVParsingUtil::FindVariableStoring(uint32_t variable_id)
+void SpirVParsingUtil::ShrinkToFit()
 {
-    for (const Instruction* store_insn : store_instructions_)
-    {
-        if (store_insn->operand(0) == variable_id)
-        {
-            // Note: This will find the first store, there could be multiple
-            return FindDef(store_insn->operand(1));
-        }
-    }
-    return nullptr;
+    instructions_.ShrinkToFit();
+    decorations_.ShrinkToFit();
+    store_heads_.shrink_to_fit();
+    store_records_.shrink_to_fit();
+    names_.shrink_to_fit();
+    member_names_.ShrinkToFit();
+    variable_visits_.shrink_to_fit();
+    block_variables_.shrink_to_fit();
+    pending_paths_.shrink_to_fit();
+    stored_objects_.shrink_to_fit();
 }
 
-bool SpirVParsingUtil::GetVariableDecorations(const Instruction*   variable_insn,
+bool SpirVParsingUtil::GetVariableDecorations(Instruction          variable_insn,
                                               BufferReferenceInfo& buffer_reference_info)
 {
-    const uint32_t variable_id   = variable_insn->resultId();
-    const uint32_t storage_class = variable_insn->operand(0);
+    const uint32_t variable_id   = variable_insn.resultId();
+    const uint32_t storage_class = variable_insn.operand(0);
 
     switch (storage_class)
     {
 
         case spv::StorageClassUniform:
-            buffer_reference_info.source = BufferReferenceLocation::UNIFORM_BUFFER;
+        {
+            // legacy storage-buffers are Uniform variables of a BufferBlock struct
+            Instruction pointer_type = FindDef(variable_insn.typeId());
+            const uint32_t     block_id     = pointer_type ? pointer_type.operand(1) : 0;
+            const auto*        decorations  = decorations_.Find(block_id);
+            buffer_reference_info.source =
+                decorations && decorations->has(SpirVDecorationIndex::Decorations::BUFFER_BLOCK)
+                    ? BufferReferenceLocation::STORAGE_BUFFER
+                    : BufferReferenceLocation::UNIFORM_BUFFER;
             break;
+        }
 
         case spv::StorageClassStorageBuffer:
             buffer_reference_info.source = BufferReferenceLocation::STORAGE_BUFFER;
@@ -154,92 +160,349 @@ bool SpirVParsingUtil::GetVariableDecorations(const Instruction*   variable_insn
             return true;
 
         default:
-            printf("Storage class %u not handled\n", storage_class);
+            diagnostics_.Report(SpirVDiagnosticCode::STORAGE_CLASS_NOT_HANDLED,
+                                variable_insn.opcode(),
+                                variable_insn.word_offset(),
+                                storage_class);
             return false;
     }
 
-    for (const Instruction* insn : decorations_instructions_)
+    if (const SpirVDecorationIndex::Decorations* decorations = decorations_.Find(variable_id))
     {
-        if (insn->operand(0) != variable_id)
+        buffer_reference_info.set     = decorations->descriptor_set;
+        buffer_reference_info.binding = decorations->binding;
+    }
+    return true;
+}
+
+const char* SpirVParsingUtil::FindName(uint32_t id) const
+{
+    return id < names_.size() ? names_[id] : nullptr;
+}
+
+const char* SpirVParsingUtil::FindMemberName(uint32_t struct_id, uint32_t member) const
+{
+    const char* const* name = member_names_.Find(struct_id, member);
+    return name ? *name : nullptr;
+}
+
+uint32_t SpirVParsingUtil::GetArrayStride(uint32_t array_type_id) const
+{
+    const SpirVDecorationIndex::Decorations* decorations = decorations_.Find(array_type_id);
+    return decorations && decorations->has(SpirVDecorationIndex::Decorations::ARRAY_STRIDE) ? decorations->array_stride
+                                                                                           : 0;
+}
+
+uint32_t SpirVParsingUtil::GetMemberOffset(uint32_t struct_id, uint32_t member) const
+{
+    const SpirVDecorationIndex::Decorations* decorations = decorations_.FindMember(struct_id, member);
+    return decorations && decorations->has(SpirVDecorationIndex::Decorations::OFFSET) ? decorations->offset : 0;
+}
+
+std::string SpirVParsingUtil::GetRootName(Instruction variable_insn, Instruction type_insn)
+{
+    // push-constant-blocks are known by their type, as there can only be one per entry-point
+    const char* variable_name = FindName(variable_insn.resultId());
+    if (variable_insn.operand(0) != spv::StorageClassPushConstant && variable_name && variable_name[0] != '\0')
+    {
+        return variable_name;
+    }
+
+    // e.g. push-constant-block or anonymous uniform-block
+    // store typename instead
+    while (type_insn && (type_insn.opcode() == spv::OpTypeArray || type_insn.opcode() == spv::OpTypeRuntimeArray))
+    {
+        type_insn = FindDef(type_insn.operand(0));
+    }
+    const char* type_name = type_insn ? FindName(type_insn.resultId()) : nullptr;
+    return type_name ? "(" + std::string(type_name) + ")" : "";
+}
+
+bool SpirVParsingUtil::ResolveBufferReference(Instruction                     variable_insn,
+                                              const std::vector<AccessIndex>& access_chain,
+                                              BufferReferenceInfo&            buffer_reference_info,
+                                              std::vector<std::string>&       access_chain_names)
+{
+    Instruction pointer_type = FindDef(variable_insn.typeId());
+    if (!pointer_type || pointer_type.opcode() != spv::OpTypePointer)
+    {
+        return false;
+    }
+    Instruction type_insn = FindDef(pointer_type.operand(1));
+
+    // access-chain starts with descriptor-binding root
+    access_chain_names = {GetRootName(variable_insn, type_insn)};
+
+    // follow access-chain through the types, offsets come straight from the Offset/ArrayStride decorations
+    for (const AccessIndex& index : access_chain)
+    {
+        if (!type_insn)
         {
-            continue;
+            return false;
         }
-        if (insn->operand(1) == spv::DecorationDescriptorSet)
+
+        // the address is stored here (as a pointer or a uint64_t), the rest of the chain indexes the pointee
+        if (type_insn.opcode() == spv::OpTypePointer ||
+            (type_insn.opcode() == spv::OpTypeInt && type_insn.operand(0) == 64))
         {
-            buffer_reference_info.set = insn->operand(2);
+            break;
         }
-        else if (insn->operand(1) == spv::DecorationBinding)
+
+        switch (type_insn.opcode())
         {
-            buffer_reference_info.binding = insn->operand(2);
+            case spv::OpTypeStruct:
+            {
+                // struct members can only be selected by constants
+                if (!index.is_constant || index.value >= type_insn.num_operands())
+                {
+                    diagnostics_.Report(
+                        SpirVDiagnosticCode::ACCESS_CHAIN_OUT_OF_BOUNDS, type_insn.opcode(), type_insn.word_offset());
+                    return false;
+                }
+                const uint32_t struct_id  = type_insn.resultId();
+                const char*    member_name = FindMemberName(struct_id, index.value);
+
+                buffer_reference_info.buffer_offset += GetMemberOffset(struct_id, index.value);
+                access_chain_names.emplace_back(member_name ? member_name : "unknown");
+                type_insn = FindDef(type_insn.operand(index.value));
+                break;
+            }
+            case spv::OpTypeArray:
+            case spv::OpTypeRuntimeArray:
+            {
+                // a known element folds into the offset, a dynamic one is reported through the stride
+                const uint32_t array_stride = GetArrayStride(type_insn.resultId());
+                if (index.is_constant)
+                {
+                    buffer_reference_info.buffer_offset += index.value * array_stride;
+                }
+                else
+                {
+                    buffer_reference_info.array_stride = array_stride;
+                }
+                type_insn = FindDef(type_insn.operand(0));
+                break;
+            }
+            case spv::OpTypeVector:
+            {
+                // e.g. an address stored in a u64vec2, components are tightly packed
+                Instruction component_type = FindDef(type_insn.operand(0));
+                const uint32_t     component_size = component_type ? component_type.operand(0) / 8 : 0;
+                if (index.is_constant)
+                {
+                    buffer_reference_info.buffer_offset += index.value * component_size;
+                }
+                else
+                {
+                    buffer_reference_info.array_stride = component_size;
+                }
+                type_insn = component_type;
+                break;
+            }
+            default:
+                diagnostics_.Report(
+                    SpirVDiagnosticCode::ACCESS_CHAIN_OUT_OF_BOUNDS, type_insn.opcode(), type_insn.word_offset());
+                return false;
         }
     }
-    return true;
+
+    if (!type_insn)
+    {
+        return false;
+    }
+
+    if (type_insn.opcode() == spv::OpTypeRuntimeArray)
+    {
+        buffer_reference_info.array_stride = GetArrayStride(type_insn.resultId());
+    }
+
+    // buffer-references traced back to either pointer-type, uin64_t or arrays of those
+    const uint32_t type_opcode = type_insn.opcode();
+    if (type_opcode == spv::OpTypePointer || (type_opcode == spv::OpTypeInt && type_insn.operand(0) == 64) ||
+        type_opcode == spv::OpTypeRuntimeArray)
+    {
+        return true;
+    }
+    diagnostics_.Report(SpirVDiagnosticCode::TYPE_MISMATCH, type_opcode, type_insn.word_offset());
+    return false;
+}
+
+void SpirVParsingUtil::CollectBufferReferences(Instruction         type_insn,
+                                               BufferReferenceInfo buffer_reference_info,
+                                               const char*         member_name)
+{
+    if (!type_insn)
+    {
+        return;
+    }
+
+    switch (type_insn.opcode())
+    {
+        case spv::OpTypePointer:
+            // the pointee lives in another buffer, so don't descend into it
+            if (type_insn.operand(0) == spv::StorageClassPhysicalStorageBuffer)
+            {
+                // a traced-back access to the same location is more precise, keep that one
+                buffer_reference_map_.try_emplace(buffer_reference_info,
+                                                  std::vector<std::string>{member_name ? member_name : "unknown"});
+            }
+            break;
+
+        case spv::OpTypeStruct:
+        {
+            const uint32_t struct_id = type_insn.resultId();
+            for (uint32_t m = 0; m < type_insn.num_operands(); ++m)
+            {
+                BufferReferenceInfo member_info = buffer_reference_info;
+                member_info.buffer_offset += GetMemberOffset(struct_id, m);
+
+                CollectBufferReferences(FindDef(type_insn.operand(m)), member_info, FindMemberName(struct_id, m));
+            }
+            break;
+        }
+
+        case spv::OpTypeArray:
+        case spv::OpTypeRuntimeArray:
+            if (buffer_reference_info.array_stride == 0)
+            {
+                buffer_reference_info.array_stride = GetArrayStride(type_insn.resultId());
+            }
+            CollectBufferReferences(FindDef(type_insn.operand(0)), buffer_reference_info, member_name);
+            break;
+
+        default:
+            break;
+    }
+}
+
+bool SpirVParsingUtil::UsesBufferDeviceAddress(const uint32_t* spirv_code, size_t spirv_num_bytes)
+{
+    return SpirVScanner::HasCapability(spirv_code, spirv_num_bytes, spv::CapabilityPhysicalStorageBufferAddresses);
 }
 
 bool SpirVParsingUtil::ParseBufferReferences(const uint32_t* const spirv_code, size_t spirv_num_bytes)
 {
+    const bool success = FindBufferReferences(spirv_code, spirv_num_bytes);
+    diagnostics_.Print(output_);
+    if (!success)
+    {
+        return false;
+    }
+    PrintBufferReferences();
+    return true;
+}
+
+bool SpirVParsingUtil::FindBufferReferences(const uint32_t* const spirv_code, size_t spirv_num_bytes)
+{
+    return DecodeModule(spirv_code, spirv_num_bytes) && TrackBackBufferReferences();
+}
+
+bool SpirVParsingUtil::DecodeModule(const uint32_t* const spirv_code, size_t spirv_num_bytes)
+{
+    diagnostics_.Clear();
+    module_code_      = nullptr;
+    module_num_bytes_ = 0;
     if (spirv_code == nullptr)
     {
         return false;
     }
 
-    definitions_.clear();
-    store_instructions_.clear();
-    decorations_instructions_.clear();
+    // the previous module's tables are still in place, so this is where it is known how much they needed
+    const size_t previous_used_bytes = std::max(used_bytes(), released_used_bytes_);
+    released_used_bytes_             = 0;
+    if (retention_policy_.Update(previous_used_bytes, retained_bytes()))
+    {
+        ShrinkToFit();
+    }
+
+    store_records_.clear();
+    names_.clear();
+    member_names_.Clear();
+    block_variables_.clear();
     buffer_reference_map_.clear();
 
-    // use in combination with spirv-reflect
-    std::optional<SpvReflectShaderModule> spv_shader_module;
+    if (spirv_num_bytes < SpirVScanner::kHeaderSize * sizeof(uint32_t))
+    {
+        diagnostics_.Report(SpirVDiagnosticCode::MODULE_TOO_SMALL);
+        return false;
+    }
 
-    // spirv-header is 5 d-words
-    constexpr uint32_t spirv_header_size = 5;
-    const uint32_t*    spirv_ptr         = spirv_code;
-    const uint32_t*    spirv_end         = spirv_code + (spirv_num_bytes / sizeof(uint32_t));
+    // most modules don't use buffer device addresses, skip those before touching anything past the capabilities
+    if (!UsesBufferDeviceAddress(spirv_code, spirv_num_bytes))
+    {
+        return true;
+    }
 
-    // skip header
-    spirv_ptr += spirv_header_size;
+    // prepass, validates the instruction lengths and counts what the tables below need without decoding anything.
+    // It only reads the first word of each instruction, so a broken module is rejected before anything is allocated
+    const SpirVScanner::Result scan = SpirVScanner::Scan(spirv_code, spirv_num_bytes);
+    if (scan.status != SpirVScanner::Status::SUCCESS)
+    {
+        diagnostics_.Report(SpirVDiagnosticCode::INVALID_INSTRUCTION_LENGTH);
+        return false;
+    }
 
-    std::vector<Instruction> instructions;
+    // build up the instruction table to make it easier to work with the SPIR-V, sized exactly by the prepass
+    if (instructions_.Build(spirv_code, spirv_num_bytes, scan.num_instructions) != SpirVInstructionTable::Status::SUCCESS)
+    {
+        diagnostics_.Report(SpirVDiagnosticCode::INVALID_ID_BOUND, SpirVDiagnostic::kNone, SpirVDiagnostic::kNone,
+                            scan.id_bound);
+        return false;
+    }
+    first_function_index_ = scan.first_function_index;
 
-    bool found_buffer_ref = false;
+    const uint32_t id_bound = instructions_.id_bound();
+    decorations_.Reset(id_bound);
 
-    // build up instructions object to make it easier to work with the SPIR-V
-    // also checks for required capability
-    while (spirv_ptr < spirv_end)
+    // stripped modules have no OpName, don't allocate a name per ID for them
+    if (scan.num_names > 0)
     {
-        Instruction& insn = instructions.emplace_back(spirv_ptr);
-        spirv_ptr += insn.length();
-        assert(insn.length() > 0);
+        names_.assign(id_bound, nullptr);
+    }
 
-        if (insn.opcode() == spv::OpCapability && insn.word(1) == spv::CapabilityPhysicalStorageBufferAddresses)
-        {
-            found_buffer_ref = true;
-        }
+    store_heads_.assign(id_bound, 0);
+    store_records_.reserve(scan.num_stores);
+    member_names_.Reserve(scan.num_member_names);
+    block_variables_.reserve(scan.count(SpirVScanner::VARIABLE));
+    variable_visits_.assign(id_bound, 0);
+    visit_generation_ = 0;
 
-        // arrived at 'OpFunction' -> we have seen all metadata incl. capabilities
-        if (insn.opcode() == spv::OpFunction)
-        {
-            // CapabilityPhysicalStorageBufferAddresses not found
-            if (!found_buffer_ref)
-            {
-                return true;
-            }
-        }
-    }
-    if (spirv_ptr != spirv_end)
+    module_code_      = spirv_code;
+    module_num_bytes_ = spirv_num_bytes;
+    return true;
+}
+
+bool SpirVParsingUtil::TrackBackBufferReferences()
+{
+    if (module_code_ == nullptr)
     {
-        printf("warning: error during SpirV-parsing, mismatching instruction-lengths");
-        return false;
+        return true;
     }
-    instructions.shrink_to_fit();
+    const uint32_t* const spirv_code      = module_code_;
+    const size_t          spirv_num_bytes = module_num_bytes_;
 
-    if (spv_shader_module == std::nullopt)
+    // use in combination with spirv-reflect
+    std::optional<SpvReflectShaderModule> spv_shader_module;
+
+    if (layout_source_ == LayoutSource::SPIRV_REFLECT)
     {
-        // spirv-reflect parsing only on-demand
+        // spirv-reflect parsing only on-demand.
+        // The SPIR-V outlives the module, and only descriptor-bindings and push-constant-blocks are needed.
+        // The module lives for this call only, so it is built in an arena and released in one go
+        constexpr SpvReflectModuleFlags reflect_flags = SPV_REFLECT_MODULE_FLAG_NO_COPY |
+                                                        SPV_REFLECT_MODULE_FLAG_NO_SOURCE |
+                                                        SPV_REFLECT_MODULE_FLAG_NO_ENTRY_POINTS |
+                                                        SPV_REFLECT_MODULE_FLAG_ARENA;
         spv_shader_module = SpvReflectShaderModule();
-        spvReflectCreateShaderModule(spirv_num_bytes, spirv_code, &spv_shader_module.value());
+        if (spvReflectCreateShaderModule2(reflect_flags, spirv_num_bytes, spirv_code, &spv_shader_module.value()) !=
+            SPV_REFLECT_RESULT_SUCCESS)
+        {
+            diagnostics_.Report(SpirVDiagnosticCode::REFLECT_FAILED);
+            return false;
+        }
     }
 
+    if (spv_shader_module != std::nullopt)
     {
         // define a function to walk blocks breadth-first and check for buffer-references
         auto check_buffer_references =
@@ -269,7 +532,11 @@ bool SpirVParsingUtil::ParseBufferReferences(const uint32_t* const spirv_code, s
                         }
 
                         // insert into map
-                        buffer_reference_map_[ref_info] = {td->struct_member_name};
+                        buffer_reference_map_[ref_info] = {td->struct_member_name ? td->struct_member_name
+                                                                                  : "unknown"};
+
+                        // the pointee lives in another buffer, so don't descend into it
+                        continue;
                     }
 
                     for (uint32_t j = 0; j < td->member_count; ++j)
@@ -350,190 +617,297 @@ bool SpirVParsingUtil::ParseBufferReferences(const uint32_t* const spirv_code, s
         }
     }
 
-    auto track_back_instruction = [this, &spv_shader_module, spirv_code, spirv_num_bytes](
-                                      const Instruction* object_insn) {
-        // keep track of access-chain
-        std::vector<uint32_t> access_indices;
+    // resolve a non-Function variable plus the access-chain used on it into a buffer-reference
+    auto resolve_variable = [this, &spv_shader_module](Instruction                     variable_insn,
+                                                        const std::vector<AccessIndex>& access_chain) {
+        BufferReferenceInfo      buffer_reference_info = {};
+        std::vector<std::string> access_chain_names;
+
+        if (!GetVariableDecorations(variable_insn, buffer_reference_info))
+        {
+            return;
+        }
+
+        if (spv_shader_module == std::nullopt)
+        {
+            if (ResolveBufferReference(variable_insn, access_chain, buffer_reference_info, access_chain_names))
+            {
+                buffer_reference_map_[buffer_reference_info] = access_chain_names;
+            }
+            return;
+        }
+
+        SpvReflectResult                 spv_result;
+        const SpvReflectTypeDescription* td = nullptr;
+
+        // access-chain starts with descriptor-binding root
+        std::string root_name;
 
-        // We are where a buffer-reference was accessed, now walk back to find where it came from
-        while (object_insn)
+        if (buffer_reference_info.source == BufferReferenceLocation::PUSH_CONSTANT_BLOCK)
         {
-            switch (object_insn->opcode())
+            // entry-points are not reflected, pick the module's block for this variable
+            for (uint32_t i = 0; i < spv_shader_module->push_constant_block_count; ++i)
             {
-                case spv::OpConvertUToPtr:
-                case spv::OpCopyLogical:
-                case spv::OpLoad:
-                    object_insn = FindDef(object_insn->operand(0));
-                    break;
-                case spv::OpAccessChain:
+                const SpvReflectBlockVariable& block = spv_shader_module->push_constant_blocks[i];
+                if (block.spirv_id == variable_insn.resultId())
                 {
-                    std::vector<uint32_t> indices;
-                    for (uint32_t i = 1; i < object_insn->num_operands(); ++i)
-                    {
-                        if (auto ins = FindDef(object_insn->operand(i)))
-                        {
-                            if (ins->opcode() == spv::OpConstant)
-                            {
-                                // store access-chain index
-                                indices.push_back(ins->constant_value());
-                            }
-                        }
-                    }
-                    // insert new indices in front
-                    access_indices.insert(access_indices.begin(), indices.begin(), indices.end());
+                    td = block.type_description;
+                }
+            }
+            if (td == nullptr)
+            {
+                return;
+            }
+        }
+        else
+        {
+            const SpvReflectDescriptorBinding* spv_descriptor_binding = spvReflectGetDescriptorBinding(
+                &spv_shader_module.value(), buffer_reference_info.binding, buffer_reference_info.set, &spv_result);
+            if (spv_descriptor_binding == nullptr)
+            {
+                // e.g. shader-record-buffers are not descriptors
+                return;
+            }
+            td        = spv_descriptor_binding->type_description;
+            root_name = spv_descriptor_binding->name;
+        }
+
+        if (root_name.empty())
+        {
+            // e.g. push-constant-block or anonymous uniform-block
+            // store typename instead
+            root_name = td->type_name ? "(" + std::string(td->type_name) + ")" : "";
+        }
+        access_chain_names = {root_name};
 
-                    // continue with base object
-                    object_insn = FindDef(object_insn->operand(0));
-                    break;
+        // follow access-chain, spirv-reflect folds arrays into their element type so only constants are used
+        for (const AccessIndex& index : access_chain)
+        {
+            // the address is stored here (as a pointer or a uint64_t), the rest of the chain indexes the pointee
+            if (td->storage_class == spv::StorageClassPhysicalStorageBuffer ||
+                (td->op == SpvOpTypeInt && td->traits.numeric.scalar.width == 64))
+            {
+                break;
+            }
+            if (!index.is_constant)
+            {
+                continue;
+            }
+            const uint32_t idx = index.value;
+            if (idx >= td->member_count)
+            {
+                diagnostics_.Report(SpirVDiagnosticCode::ACCESS_CHAIN_OUT_OF_BOUNDS, td->op);
+                return;
+            }
+
+            if (td->op == SpvOpTypeArray || td->op == SpvOpTypeRuntimeArray)
+            {
+                buffer_reference_info.array_stride = td->traits.array.stride;
+            }
+
+            // offset calculation
+            for (uint32_t m = 0; m < idx; ++m)
+            {
+                uint32_t    num_scalar_bytes = 0;
+                const auto& member           = td->members[m];
+                num_scalar_bytes             = member.traits.numeric.scalar.width / 8;
+
+                if (member.op == SpvOpTypeVector)
+                {
+                    num_scalar_bytes *= member.traits.numeric.vector.component_count;
                 }
-                case spv::OpVariable:
+                else if (member.op == SpvOpTypeMatrix)
                 {
-                    const uint32_t storage_class = object_insn->operand(0);
-                    if (storage_class == spv::StorageClassFunction)
-                    {
-                        // When casting to a struct, can get a 2nd function variable, just keep following
-                        object_insn = FindVariableStoring(object_insn->resultId());
-                    }
-                    else
-                    {
-                        BufferReferenceInfo buffer_reference_info = {};
+                    num_scalar_bytes *= member.traits.numeric.matrix.column_count;
+                    num_scalar_bytes *= member.traits.numeric.matrix.row_count;
+                    num_scalar_bytes = std::max(num_scalar_bytes, member.traits.numeric.matrix.stride);
+                }
+                else if (member.op == SpvOpTypePointer || member.op == SpvOpTypeForwardPointer)
+                {
+                    num_scalar_bytes = sizeof(uint64_t);
+                }
+                else if (member.op == SpvOpTypeArray || member.op == SpvOpTypeRuntimeArray)
+                {
+                    num_scalar_bytes = std::max(num_scalar_bytes, member.traits.array.stride);
+                    assert(false); // not handled
+                }
+                buffer_reference_info.buffer_offset += num_scalar_bytes;
+            }
 
-                        if (GetVariableDecorations(object_insn, buffer_reference_info))
-                        {
-                            SpvReflectResult                 spv_result;
-                            const SpvReflectTypeDescription* td = nullptr;
+            td = td->members + idx;
+            access_chain_names.emplace_back(td->struct_member_name ? td->struct_member_name : "unknown");
+        }
 
-                            // access-chain starts with descriptor-binding root
-                            std::string root_name;
+        if (td->op == SpvOpTypeRuntimeArray)
+        {
+            buffer_reference_info.array_stride = td->traits.array.stride;
+        }
 
-                            if (buffer_reference_info.source == BufferReferenceLocation::PUSH_CONSTANT_BLOCK)
-                            {
-                                const SpvReflectBlockVariable* block = spvReflectGetEntryPointPushConstantBlock(
-                                    &spv_shader_module.value(), spv_shader_module->entry_point_name, &spv_result);
-                                td = block->type_description;
-                            }
-                            else
-                            {
-                                const SpvReflectDescriptorBinding* spv_descriptor_binding =
-                                    spvReflectGetDescriptorBinding(&spv_shader_module.value(),
-                                                                   buffer_reference_info.binding,
-                                                                   buffer_reference_info.set,
-                                                                   &spv_result);
-                                td        = spv_descriptor_binding->type_description;
-                                root_name = spv_descriptor_binding->name;
-                            }
+        // buffer-references traced back to either pointer-type, uin64_t or arrays of those. spirv-reflect describes a
+        // pointer by its pointee, only the storage class tells them apart
+        if (td->storage_class == spv::StorageClassPhysicalStorageBuffer || td->op == SpvOpTypePointer ||
+            td->op == SpvOpTypeForwardPointer ||
+            (td->op == SpvOpTypeInt && td->traits.numeric.scalar.width == 64) || td->op == SpvOpTypeRuntimeArray)
+        {
+            buffer_reference_map_[buffer_reference_info] = access_chain_names;
+        }
+        else
+        {
+            diagnostics_.Report(SpirVDiagnosticCode::TYPE_MISMATCH, td->op);
+        }
+    };
 
-                            if (root_name.empty())
-                            {
-                                // e.g. push-constant-block or anonymous uniform-block
-                                // store typename instead
-                                root_name = td->type_name ? "(" + std::string(td->type_name) + ")" : "";
-                            }
-                            std::vector<std::string> access_chain_names = { root_name };
+    auto track_back_instruction = [this, &resolve_variable](Instruction start_insn) {
+        // Function variables can be stored to more than once and every store starts its own path.
+        // A path is the instruction to continue from plus the access-chain indices collected so far.
+        std::vector<std::pair<Instruction, std::vector<AccessIndex>>>& pending_paths = pending_paths_;
+        pending_paths.clear();
+        pending_paths.emplace_back(start_insn, std::vector<AccessIndex>());
+
+        // stores can form cycles (e.g. 'node = node.next'), so every Function variable is only followed once
+        ++visit_generation_;
 
-                            // follow access-chain
-                            for (uint32_t idx : access_indices)
+        while (!pending_paths.empty())
+        {
+            auto [object_insn, access_chain] = std::move(pending_paths.back());
+            pending_paths.pop_back();
+
+            // We are where a buffer-reference was accessed, now walk back to find where it came from
+            while (object_insn)
+            {
+                switch (object_insn.opcode())
+                {
+                    case spv::OpConvertUToPtr:
+                    case spv::OpCopyLogical:
+                    case spv::OpLoad:
+                        object_insn = FindDef(object_insn.operand(0));
+                        break;
+                    case spv::OpAccessChain:
+                    {
+                        std::vector<AccessIndex> indices;
+                        for (uint32_t i = 1; i < object_insn.num_operands(); ++i)
+                        {
+                            // store access-chain index, the value is only known for constants
+                            AccessIndex& index = indices.emplace_back();
+                            if (auto ins = FindDef(object_insn.operand(i)))
                             {
-                                if (idx < td->member_count)
-                                {
-                                    if (td->op == SpvOpTypeArray || td->op == SpvOpTypeRuntimeArray)
-                                    {
-                                        buffer_reference_info.array_stride = td->traits.array.stride;
-                                    }
-
-                                    // offset calculation
-                                    for (uint32_t m = 0; m < idx; ++m)
-                                    {
-                                        uint32_t    num_scalar_bytes = 0;
-                                        const auto& member           = td->members[m];
-                                        num_scalar_bytes             = member.traits.numeric.scalar.width / 8;
-
-                                        if (member.op == SpvOpTypeVector)
-                                        {
-                                            num_scalar_bytes *= member.traits.numeric.vector.component_count;
-                                        }
-                                        else if (member.op == SpvOpTypeMatrix)
-                                        {
-                                            num_scalar_bytes *= member.traits.numeric.matrix.column_count;
-                                            num_scalar_bytes *= member.traits.numeric.matrix.row_count;
-                                            num_scalar_bytes =
-                                                std::max(num_scalar_bytes, member.traits.numeric.matrix.stride);
-                                        }
-                                        else if (member.op == SpvOpTypePointer || member.op == SpvOpTypeForwardPointer)
-                                        {
-                                            num_scalar_bytes = sizeof(uint64_t);
-                                        }
-                                        else if (member.op == SpvOpTypeArray || member.op == SpvOpTypeRuntimeArray)
-                                        {
-                                            num_scalar_bytes = std::max(num_scalar_bytes, member.traits.array.stride);
-                                            assert(false); // not handled
-                                        }
-                                        buffer_reference_info.buffer_offset += num_scalar_bytes;
-                                    }
-
-                                    td = td->members + idx;
-                                    access_chain_names.emplace_back(td->struct_member_name ? td->struct_member_name
-                                                                                           : "unknown");
-                                }
-                                else
+                                if (ins.opcode() == spv::OpConstant)
                                 {
-                                    printf("warning: Access-chain index is out-of-bounds for op: %s\n",
-                                                         string_SpvOpcode(td->op));
-                                    return;
+                                    index.value       = ins.constant_value();
+                                    index.is_constant = true;
                                 }
                             }
-                            access_indices.clear();
+                        }
+                        // insert new indices in front
+                        access_chain.insert(access_chain.begin(), indices.begin(), indices.end());
 
-                            if (td->op == SpvOpTypeRuntimeArray)
-                            {
-                                buffer_reference_info.array_stride = td->traits.array.stride;
-                            }
+                        // continue with base object
+                        object_insn = FindDef(object_insn.operand(0));
+                        break;
+                    }
+                    case spv::OpVariable:
+                    {
+                        const uint32_t variable_id = object_insn.resultId();
+                        if (object_insn.operand(0) != spv::StorageClassFunction)
+                        {
+                            resolve_variable(object_insn, access_chain);
+                        }
+                        else if (variable_id < variable_visits_.size() &&
+                                 variable_visits_[variable_id] != visit_generation_)
+                        {
+                            variable_visits_[variable_id] = visit_generation_;
 
-                            // buffer-references traced back to either pointer-type, uin64_t or arrays of those
-                            if (td->op == SpvOpTypePointer || td->op == SpvOpTypeForwardPointer ||
-                                (td->op == SpvOpTypeInt && td->traits.numeric.scalar.width == 64) ||
-                                td->op == SpvOpTypeRuntimeArray)
+                            // When casting to a struct, can get a 2nd function variable, just keep following
+                            stored_objects_.clear();
+                            FindVariableStores(variable_id, stored_objects_);
+                            for (Instruction stored_insn : stored_objects_)
                             {
-                                buffer_reference_map_[buffer_reference_info] = access_chain_names;
-                            }
-                            else
-                            {
-                                printf("warning: Traced back a potential buffer-reference, but type does not match: %s\n",
-                                       string_SpvOpcode(td->op));
+                                pending_paths.emplace_back(stored_insn, access_chain);
                             }
                         }
-                        object_insn = nullptr;
+                        object_insn = Instruction();
+                        break;
                     }
-                    break;
+                    default:
+                        diagnostics_.Report(SpirVDiagnosticCode::UNTRACEABLE_STORE,
+                                            object_insn.opcode(),
+                                            object_insn.word_offset());
+                        object_insn = Instruction();
+                        break;
                 }
-                default:
-                    printf("warning: Failed to track back the Function Variable OpStore, hit a %s\n",
-                           string_SpvOpcode(object_insn->opcode()));
-                    object_insn = nullptr;
-                    break;
             }
         }
     };
 
-    // Now we can walk the SPIR-V one more time to find what we need
-    for (const Instruction& insn : instructions)
+    // block variables that can hold buffer-references, scanned natively once the pass is done
+    std::vector<Instruction>& block_variables = block_variables_;
+
+    // Now we can walk the SPIR-V one more time to find what we need. The logical layout puts the names, decorations
+    // and global variables before the first function and every load and store inside one, so each part of the
+    // module is only checked for its own opcodes
+    const uint32_t num_instructions     = static_cast<uint32_t>(instructions_.size());
+    const uint32_t first_function_index = static_cast<uint32_t>(std::min(first_function_index_, instructions_.size()));
+    for (uint32_t index = 0; index < first_function_index; index++)
     {
-        // because it is SSA, we can build this up as we are looping in this pass
-        const uint32_t result_id = insn.resultId();
-        if (result_id != 0)
+        const Instruction insn   = instructions_[index];
+        const uint32_t    opcode = insn.opcode();
+
+        // a malformed module can cut an instruction short, its missing operands would be read from the next one
+        if (insn.num_operands() < GetMinimumOperands(opcode))
         {
-            definitions_[result_id] = &insn;
+            continue;
         }
 
-        const uint32_t opcode = insn.opcode();
+        if (opcode == spv::OpDecorate)
+        {
+            decorations_.AddDecoration(insn.operand(0), insn.operand(1), insn.num_operands() > 2 ? insn.operand(2) : 0);
+        }
+        else if (opcode == spv::OpMemberDecorate)
+        {
+            decorations_.AddMemberDecoration(
+                insn.operand(0), insn.operand(1), insn.operand(2), insn.num_operands() > 3 ? insn.operand(3) : 0);
+        }
+        else if (opcode == spv::OpName && insn.operand(0) < names_.size())
+        {
+            // nullptr for a name without its terminator, the ID stays unnamed
+            names_[insn.operand(0)] = insn.operand_string(1);
+        }
+        else if (opcode == spv::OpMemberName)
+        {
+            if (const char* member_name = insn.operand_string(2))
+            {
+                member_names_(insn.operand(0), insn.operand(1)) = member_name;
+            }
+        }
+        else if (opcode == spv::OpVariable)
+        {
+            const uint32_t storage_class = insn.operand(0);
+            if (storage_class == spv::StorageClassUniform || storage_class == spv::StorageClassStorageBuffer ||
+                storage_class == spv::StorageClassShaderRecordBufferKHR || storage_class == spv::StorageClassPushConstant)
+            {
+                block_variables.push_back(insn);
+            }
+        }
+    }
 
-        if (opcode == spv::OpStore)
+    for (uint32_t index = first_function_index; index < num_instructions; index++)
+    {
+        const Instruction insn   = instructions_[index];
+        const uint32_t    opcode = insn.opcode();
+        if (insn.num_operands() < GetMinimumOperands(opcode))
         {
-            store_instructions_.push_back(&insn);
+            continue;
         }
-        else if (opcode == spv::OpDecorate)
+
+        if (opcode == spv::OpStore)
         {
-            decorations_instructions_.push_back(&insn);
+            const uint32_t pointer_id = insn.operand(0);
+            if (pointer_id < store_heads_.size())
+            {
+                store_records_.push_back({insn.index(), store_heads_[pointer_id]});
+                store_heads_[pointer_id] = static_cast<uint32_t>(store_records_.size());
+            }
+            continue;
         }
 
         // There is always a load that does the dereferencing
@@ -543,71 +917,173 @@ bool SpirVParsingUtil::ParseBufferReferences(const uint32_t* const spirv_code, s
         }
 
         // Confirms the load is used for a buffer device address
-        const Instruction* type_pointer_insn = FindDef(insn.typeId());
-        if (!type_pointer_insn || type_pointer_insn->opcode() != spv::OpTypePointer ||
-            type_pointer_insn->operand(0) != spv::StorageClassPhysicalStorageBuffer)
+        Instruction type_pointer_insn = FindDef(insn.typeId());
+        if (!type_pointer_insn || type_pointer_insn.opcode() != spv::OpTypePointer ||
+            type_pointer_insn.operand(0) != spv::StorageClassPhysicalStorageBuffer)
         {
             continue;
         }
 
-        const Instruction* load_pointer_insn = FindDef(insn.operand(0));
+        Instruction load_pointer_insn = FindDef(insn.operand(0));
+
+        if (load_pointer_insn && load_pointer_insn.opcode() == spv::OpVariable &&
+            load_pointer_insn.operand(0) == spv::StorageClassFunction)
+        {
+            // walks back through every store to the variable
+            track_back_instruction(load_pointer_insn);
+        }
+        else if (load_pointer_insn && load_pointer_insn.opcode() == spv::OpAccessChain)
+        {
+            track_back_instruction(load_pointer_insn);
+        }
+    }
 
-        if (load_pointer_insn && load_pointer_insn->opcode() == spv::OpVariable &&
-            load_pointer_insn->operand(0) == spv::StorageClassFunction)
+    if (spv_shader_module == std::nullopt)
+    {
+        // check all blocks for buffer-references, including those that were never dereferenced
+        for (Instruction variable_insn : block_variables)
         {
-            const Instruction* object_insn = FindVariableStoring(load_pointer_insn->resultId());
-            if (!object_insn)
+            BufferReferenceInfo buffer_reference_info = {};
+            if (!GetVariableDecorations(variable_insn, buffer_reference_info))
             {
                 continue;
             }
 
-            track_back_instruction(object_insn);
+            Instruction pointer_type = FindDef(variable_insn.typeId());
+            Instruction type_insn    = pointer_type ? FindDef(pointer_type.operand(1)) : Instruction();
+
+            CollectBufferReferences(type_insn, buffer_reference_info, nullptr);
         }
-        else if (load_pointer_insn && load_pointer_insn->opcode() == spv::OpAccessChain)
+    }
+
+    // cleanup spirv-module
+    if (spv_shader_module != std::nullopt)
+    {
+        spvReflectDestroyShaderModule(&spv_shader_module.value());
+    }
+
+    // successfully parsed
+    return true;
+}
+
+bool SpirVParsingUtil::FindBufferReferences(int                                     descriptor,
+                                            uint64_t                                module_tag,
+                                            SpirVResultRing<BufferReferenceRecord>& results)
+{
+    BufferReferenceRecord end_of_module;
+    end_of_module.module_tag = module_tag;
+    end_of_module.kind       = BufferReferenceRecord::Kind::END_OF_MODULE;
+
+    if (!shared_module_.OpenDescriptor(descriptor))
+    {
+        diagnostics_.Clear();
+        diagnostics_.Report(SpirVDiagnosticCode::UNMAPPABLE_MODULE);
+        results.TryPush(end_of_module);
+        return false;
+    }
+
+    const bool success = FindBufferReferences(shared_module_.data(), shared_module_.size_bytes());
+    if (success)
+    {
+        BufferReferenceRecord record;
+        record.module_tag = module_tag;
+        for (const auto& [buffer_reference_info, chain_names] : buffer_reference_map_)
         {
-            track_back_instruction(load_pointer_insn);
+            record.info = buffer_reference_info;
+            results.TryPush(record);
         }
+        end_of_module.success        = 1;
+        end_of_module.num_references = static_cast<uint32_t>(buffer_reference_map_.size());
     }
+    results.TryPush(end_of_module);
+
+    // the instruction table and the names point into the mapping, they go before it does
+    ReleaseModule();
+    shared_module_.Close();
+    return success;
+}
 
+void SpirVParsingUtil::PrintBufferReferences() const
+{
+    // written piece by piece, so no name is built up or truncated
     for (const auto& [buffer_reference_info, chain_names] : buffer_reference_map_)
     {
-        std::string name;
-        for (const auto& sn : chain_names)
+        fputs("buffer-reference: ", output_);
+        for (size_t i = 0; i < chain_names.size(); i++)
         {
-            name += sn + " -> ";
+            if (i > 0)
+            {
+                fputs(" -> ", output_);
+            }
+            fputs(chain_names[i].c_str(), output_);
         }
-        name = name.substr(0, name.size() - 4);
 
-        char buf[128];
+        fputs(" (", output_);
         switch (buffer_reference_info.source)
         {
             case BufferReferenceLocation::PUSH_CONSTANT_BLOCK:
-                snprintf(buf, sizeof(buf), "push-constant-block");
+                fputs("push-constant-block", output_);
+                break;
+
+            case BufferReferenceLocation::SHADER_RECORD_BUFFER:
+                fputs("shader-record-buffer", output_);
                 break;
 
             case BufferReferenceLocation::UNIFORM_BUFFER:
             case BufferReferenceLocation::STORAGE_BUFFER:
-                snprintf(
-                    buf, sizeof(buf), "set: %u, binding: %u", buffer_reference_info.set, buffer_reference_info.binding);
+                fprintf(output_, "set: %u, binding: %u", buffer_reference_info.set, buffer_reference_info.binding);
                 break;
             default:
                 break;
         }
 
-        printf("buffer-reference: %s (%s, buffer-offset: %u, array-stride: %u)\n",
-                           name.c_str(),
-                           buf,
-                           buffer_reference_info.buffer_offset,
-                           buffer_reference_info.array_stride);
+        fprintf(output_,
+                ", buffer-offset: %u, array-stride: %u)\n",
+                buffer_reference_info.buffer_offset,
+                buffer_reference_info.array_stride);
     }
-    // cleanup spirv-module
-    if (spv_shader_module != std::nullopt)
+}
+
+void SpirVParsingUtil::EmitBufferReferences(SpirVNdjsonWriter& writer) const
+{
+    for (const auto& [buffer_reference_info, chain_names] : buffer_reference_map_)
     {
-        spvReflectDestroyShaderModule(&spv_shader_module.value());
-    }
+        writer.BeginObject();
+        writer.String("type", "buffer-reference");
 
-    // successfully parsed
-    return true;
+        writer.BeginArray("chain");
+        for (const std::string& name : chain_names)
+        {
+            writer.String(name.c_str());
+        }
+        writer.EndArray();
+
+        switch (buffer_reference_info.source)
+        {
+            case BufferReferenceLocation::PUSH_CONSTANT_BLOCK:
+                writer.String("source", "push-constant-block");
+                break;
+
+            case BufferReferenceLocation::SHADER_RECORD_BUFFER:
+                writer.String("source", "shader-record-buffer");
+                break;
+
+            case BufferReferenceLocation::UNIFORM_BUFFER:
+            case BufferReferenceLocation::STORAGE_BUFFER:
+                writer.String("source",
+                              buffer_reference_info.source == BufferReferenceLocation::UNIFORM_BUFFER ? "uniform-buffer"
+                                                                                                      : "storage-buffer");
+                writer.UInt("set", buffer_reference_info.set);
+                writer.UInt("binding", buffer_reference_info.binding);
+                break;
+            default:
+                break;
+        }
+
+        writer.UInt("buffer_offset", buffer_reference_info.buffer_offset);
+        writer.UInt("array_stride", buffer_reference_info.array_stride);
+        writer.EndObject();
+    }
 }
 
 std::vector<SpirVParsingUtil::BufferReferenceInfo> SpirVParsingUtil::GetBufferReferenceInfos() const
@@ -620,3 +1096,11 @@ std::vector<SpirVParsingUtil::BufferReferenceInfo> SpirVParsingUtil::GetBufferRe
     }
     return ret;
 }
+
+void SpirVParsingUtil::WriteBufferReferences(SpirVBufferReferenceFileWriter& writer) const
+{
+    for (const auto& [buffer_reference_info, chain_names] : buffer_reference_map_)
+    {
+        writer.Add(buffer_reference_info, chain_names);
+    }
+}
@@ -24,11 +24,22 @@
 #define GFXRECONSTRUCT_UTIL_SPIRV_PARSING_UTIL_H
 
 #include <cstdint>
-#include <unordered_map>
+#include <cstdio>
 #include <map>
 #include <vector>
 #include <string>
 
+#include "spirv_decoration_index.h"
+#include "spirv_diagnostics.h"
+#include "spirv_file.h"
+#include "spirv_instruction.h"
+#include "spirv_member_map.h"
+#include "spirv_result_ring.h"
+#include "spirv_retention_policy.h"
+
+class SpirVBufferReferenceFileWriter;
+class SpirVNdjsonWriter;
+
 class SpirVParsingUtil
 {
   public:
@@ -50,24 +61,194 @@ class SpirVParsingUtil
         uint32_t                array_stride  = 0;
     };
 
-    SpirVParsingUtil() = default;
+    //! one entry pushed by FindBufferReferences(descriptor, ...), tagged with the caller's id for the module
+    struct BufferReferenceRecord
+    {
+        enum class Kind : uint32_t
+        {
+            //! 'info' is one buffer-reference of the module
+            BUFFER_REFERENCE = 0,
+
+            //! the last record of the module, 'info' is unused
+            END_OF_MODULE
+        };
+
+        uint64_t            module_tag = 0;
+        Kind                kind       = Kind::BUFFER_REFERENCE;
+        BufferReferenceInfo info       = {};
+
+        //! END_OF_MODULE: whether the module was analyzed, and how many buffer-references it has. A consumer that
+        //! received fewer lost the rest to a full ring
+        uint32_t success        = 0;
+        uint32_t num_references = 0;
+    };
+
+    //! where struct member offsets and array strides are taken from
+    enum class LayoutSource
+    {
+        //! computed from the module's own Offset/ArrayStride decorations while parsing (single parse)
+        NATIVE = 0,
+
+        //! taken from a SPIRV-Reflect module, which parses the whole binary a second time
+        SPIRV_REFLECT
+    };
+
+    //! version of the printed results, part of the result-cache key. Bump whenever the output changes
+    static constexpr uint32_t kResultVersion = 4;
+
+    explicit SpirVParsingUtil(LayoutSource layout_source = LayoutSource::NATIVE) : layout_source_(layout_source) {}
 
+    //! where ParseBufferReferences() and PrintBufferReferences() print, defaults to stdout
+    void SetOutput(FILE* output) { output_ = output; }
+
+    //! drop diagnostics below 'severity' while analyzing, by default all are kept
+    void SetMinimumSeverity(SpirVDiagnosticSeverity severity) { diagnostics_.SetMinimumSeverity(severity); }
+
+    //! what went wrong or was skipped during the last FindBufferReferences(), nothing is printed while analyzing
+    [[nodiscard]] const SpirVDiagnostics& diagnostics() const { return diagnostics_; }
+
+    //! The tables are kept between modules so a reused instance stops allocating once it has seen a module of the
+    //! size. The policy decides when that memory is given back, by default it never is
+    void SetRetentionPolicy(const SpirVRetentionPolicy& policy) { retention_policy_ = policy; }
+
+    //! bytes held by the tables of the last module
+    [[nodiscard]] size_t retained_bytes() const;
+
+    //! shrink the tables to what the last module needed
+    void ShrinkToFit();
+
+    //! true if the module declares CapabilityPhysicalStorageBufferAddresses, modules without it can't hold any
+    //! buffer-references. Only the capability preamble is read, so it is cheap enough to triage large batches
+    static bool UsesBufferDeviceAddress(const uint32_t* spirv_code, size_t spirv_num_bytes);
+
+    //! FindBufferReferences() followed by printing the diagnostics and, if it succeeded, PrintBufferReferences()
     bool ParseBufferReferences(const uint32_t* spirv_code, size_t spirv_num_bytes);
 
+    //! trace the buffer-references of a module, without printing anything.
+    //! The same as DecodeModule() followed by TrackBackBufferReferences()
+    bool FindBufferReferences(const uint32_t* spirv_code, size_t spirv_num_bytes);
+
+    //! First step of FindBufferReferences(), e.g. to time the steps on their own: build the instruction table with its
+    //! definitions and size the per-module indices. Modules without buffer device addresses stop here
+    bool DecodeModule(const uint32_t* spirv_code, size_t spirv_num_bytes);
+
+    //! Second step: index the decorations, names and stores, then track every dereferenced buffer-reference back to its
+    //! block. With SPIRV_REFLECT its module is created here as well. Does nothing for a module DecodeModule() skipped
+    bool TrackBackBufferReferences();
+
+    //! Trace the buffer-references of a module in a memfd. The descriptor is mapped read-only and the analysis runs
+    //! straight on the mapping, nothing is copied. It has to be sealed against shrinking and writing (see
+    //! SpirVFile::OpenDescriptor), unsealed descriptors fail without being mapped.
+    //! One record per buffer-reference is pushed to 'results', then an END_OF_MODULE record, all tagged with
+    //! 'module_tag'. Records that don't fit are counted in its dropped(). The tables pointing into the mapping are
+    //! dropped before this returns, the access-chain names were copied and WriteBufferReferences() still has them.
+    //! The descriptor stays owned by the caller
+    bool FindBufferReferences(int descriptor, uint64_t module_tag, SpirVResultRing<BufferReferenceRecord>& results);
+
+    //! print the buffer-references found by the last FindBufferReferences()
+    void PrintBufferReferences() const;
+
+    //! the same as one NDJSON record per buffer-reference
+    void EmitBufferReferences(SpirVNdjsonWriter& writer) const;
+
     [[nodiscard]] std::vector<BufferReferenceInfo> GetBufferReferenceInfos() const;
 
+    //! add the buffer-references found by the last FindBufferReferences() to 'writer', with their access-chain names
+    void WriteBufferReferences(SpirVBufferReferenceFileWriter& writer) const;
+
   private:
-    class Instruction;
+    using Instruction = SpirVInstruction;
+
+    // one index of an access-chain, dynamic indices have no constant value
+    struct AccessIndex
+    {
+        uint32_t value       = 0;
+        bool     is_constant = false;
+    };
+
+    [[nodiscard]] Instruction FindDef(uint32_t id) const;
+
+    // appends the objects of the stores to a Function variable seen so far, latest first
+    void FindVariableStores(uint32_t variable_id, std::vector<Instruction>& objects) const;
+
+    [[nodiscard]] size_t used_bytes() const;
+
+    // drop everything that points into the module, before its memory goes away
+    void ReleaseModule();
+    bool GetVariableDecorations(Instruction variable_insn, BufferReferenceInfo& buffer_reference_info);
+
+    // native layout, uses the instruction table plus the decoration and name indices
+    [[nodiscard]] const char* FindName(uint32_t id) const;
+    [[nodiscard]] const char* FindMemberName(uint32_t struct_id, uint32_t member) const;
+    [[nodiscard]] uint32_t    GetArrayStride(uint32_t array_type_id) const;
+    [[nodiscard]] uint32_t    GetMemberOffset(uint32_t struct_id, uint32_t member) const;
+    std::string               GetRootName(Instruction variable_insn, Instruction type_insn);
+
+    // Both layout sources name and select buffer-references the same way, only offsets and strides depend on the
+    // source. A traced access is named by its root (the variable, or "(type)" for push-constant and anonymous blocks)
+    // followed by the members of its access-chain up to the first pointer or uint64_t, the rest of the chain is
+    // inside the pointee's buffer. A buffer-reference in a block that is never dereferenced is named by its member
+    // alone
+
+    bool ResolveBufferReference(Instruction                     variable_insn,
+                                const std::vector<AccessIndex>& access_chain,
+                                BufferReferenceInfo&            buffer_reference_info,
+                                std::vector<std::string>&       access_chain_names);
+
+    void CollectBufferReferences(Instruction         type_insn,
+                                 BufferReferenceInfo buffer_reference_info,
+                                 const char*         member_name);
+
+    LayoutSource layout_source_ = LayoutSource::NATIVE;
+    FILE*        output_        = stdout;
+
+    // the module's instructions, also the LUT for hopping around instructions from a result ID
+    SpirVInstructionTable instructions_{};
+
+    // OpStore instructions per pointer ID, as a list through store_records_ so clearing keeps the memory.
+    // store_heads_ holds the latest store per ID, offset by one so 0 means "no store"
+    struct StoreRecord
+    {
+        uint32_t instruction_index = 0;
+        uint32_t previous          = 0;
+    };
+    std::vector<uint32_t>    store_heads_{};
+    std::vector<StoreRecord> store_records_{};
+
+    // set/binding/offset/... per ID, built from the OpDecorate/OpMemberDecorate instructions
+    SpirVDecorationIndex decorations_{};
+
+    // OpName strings per ID and OpMemberName strings per (struct ID, member), pointing into the SPIR-V
+    std::vector<const char*>    names_{};
+    SpirVMemberMap<const char*> member_names_{};
+
+    // scratch of the track-back, kept between modules as well
+    std::vector<Instruction>                                      block_variables_{};
+    std::vector<std::pair<Instruction, std::vector<AccessIndex>>> pending_paths_{};
+    std::vector<Instruction>                                      stored_objects_{};
+
+    // a Function variable is followed once per track-back, visited when its entry matches the current generation
+    std::vector<uint32_t> variable_visits_{};
+    uint32_t              visit_generation_ = 0;
+
+    // the module DecodeModule() left for TrackBackBufferReferences(), nullptr if there is nothing to track back
+    const uint32_t* module_code_      = nullptr;
+    size_t          module_num_bytes_ = 0;
+
+    // index of the module's first OpFunction, from the prepass
+    size_t first_function_index_ = 0;
+
+    SpirVRetentionPolicy retention_policy_{};
+
+    // used_bytes() of a module whose tables were dropped by ReleaseModule(), for the retention policy
+    size_t released_used_bytes_ = 0;
 
-    const Instruction* FindDef(uint32_t id);
-    const Instruction* FindVariableStoring(uint32_t variable_id);
-    bool GetVariableDecorations(const Instruction* variable_insn, BufferReferenceInfo& buffer_reference_info);
+    // formatted once the module is done, so the analysis never waits on a FILE lock
+    SpirVDiagnostics diagnostics_{};
 
-    // LUT for hopping around instructions from a result ID
-    std::unordered_map<uint32_t, const Instruction*> definitions_{};
+    // mapping of the module passed by descriptor, only open during FindBufferReferences()
+    SpirVFile shared_module_{};
 
-    std::vector<const Instruction*>                         store_instructions_{};
-    std::vector<const Instruction*>                         decorations_instructions_{};
     std::map<BufferReferenceInfo, std::vector<std::string>> buffer_reference_map_{};
 };
 
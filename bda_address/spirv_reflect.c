@@ -49,6 +49,8 @@ enum {
   SPIRV_DATA_ALIGNMENT                = 4 * SPIRV_WORD_SIZE, // 16
   SPIRV_ACCESS_CHAIN_INDEX_OFFSET     = 4,
   SPIRV_PHYSICAL_STORAGE_POINTER_SIZE = 8, // Pointers are defined as 64-bit
+  SPIRV_ID_BOUND_WORD_INDEX           = 3,
+  SPIRV_MAX_ID_BOUND                  = 0x3FFFFF, // Universal limit, larger bounds don't get id lookups
 };
 
 enum {
@@ -66,6 +68,12 @@ enum {
   IMAGE_STORAGE = 2,
 };
 
+enum {
+  // Every arena allocation is aligned for any of the reflection structs
+  ARENA_ALIGNMENT          = 16,
+  ARENA_MIN_BLOCK_SIZE     = 16 * 1024,
+};
+
 typedef struct SpvReflectPrvArrayTraits {
   uint32_t                        element_type_id;
   uint32_t                        length_id;
@@ -204,6 +212,19 @@ typedef struct SpvReflectPrvPhysicalPointerStruct {
     SpvReflectBlockVariable* p_var;
 } SpvReflectPrvPhysicalPointerStruct;
 
+// Bump allocator used with SPV_REFLECT_MODULE_FLAG_ARENA. Blocks double in
+// size as they are added and are only released all at once.
+typedef struct SpvReflectPrvArenaBlock {
+  struct SpvReflectPrvArenaBlock* p_next;
+  size_t                          size;
+  size_t                          used;
+} SpvReflectPrvArenaBlock;
+
+typedef struct SpvReflectPrvArena {
+  SpvReflectPrvArenaBlock*        p_blocks;  // Most recent block first
+  size_t                          next_block_size;
+} SpvReflectPrvArena;
+
 typedef struct SpvReflectPrvParser {
   size_t                          spirv_word_count;
   uint32_t*                       spirv_code;
@@ -222,6 +243,11 @@ typedef struct SpvReflectPrvParser {
   uint32_t                        access_chain_count;
   SpvReflectPrvAccessChain*       access_chains;
 
+  // Result id -> index into nodes/access_chains, see CreateIdLookup()
+  uint32_t                        id_bound;
+  uint32_t*                       node_lookup;
+  uint32_t*                       access_chain_lookup;
+
   uint32_t                        type_count;
   uint32_t                        descriptor_count;
   uint32_t                        push_constant_count;
@@ -231,6 +257,10 @@ typedef struct SpvReflectPrvParser {
 
   SpvReflectPrvPhysicalPointerStruct* physical_pointer_structs;
   uint32_t                            physical_pointer_struct_count;
+
+  // NULL unless SPV_REFLECT_MODULE_FLAG_ARENA is set, see ArenaCalloc()
+  SpvReflectPrvArena*                 p_arena;
+  SpvReflectPrvArena                  arena;
 } SpvReflectPrvParser;
 // clang-format on
 
@@ -252,6 +282,75 @@ static uint32_t RoundUp(uint32_t value, uint32_t multiple) {
     ptr = NULL;       \
   }
 
+static size_t ArenaBlockHeaderSize(void) {
+  return (sizeof(SpvReflectPrvArenaBlock) + ARENA_ALIGNMENT - 1) & ~((size_t)ARENA_ALIGNMENT - 1);
+}
+
+// calloc() replacement for everything owned by the parser or the module. With
+// no arena (the default) it is plain calloc() and the memory is released one
+// allocation at a time as before.
+static void* ArenaCalloc(SpvReflectPrvArena* p_arena, size_t count, size_t size) {
+  if (IsNull(p_arena)) {
+    return calloc(count, size);
+  }
+  if ((size != 0) && (count > (SIZE_MAX - ARENA_ALIGNMENT) / size)) {
+    return NULL;
+  }
+  // Zero sized requests still get a unique pointer, callers check for NULL
+  size_t bytes = (count * size + ARENA_ALIGNMENT - 1) & ~((size_t)ARENA_ALIGNMENT - 1);
+  if (bytes == 0) {
+    bytes = ARENA_ALIGNMENT;
+  }
+
+  SpvReflectPrvArenaBlock* p_block = p_arena->p_blocks;
+  if (IsNull(p_block) || (p_block->size - p_block->used < bytes)) {
+    size_t block_size = p_arena->next_block_size > ARENA_MIN_BLOCK_SIZE ? p_arena->next_block_size : ARENA_MIN_BLOCK_SIZE;
+    if (block_size < bytes) {
+      block_size = bytes;
+    }
+    if (block_size > SIZE_MAX - ArenaBlockHeaderSize()) {
+      return NULL;
+    }
+    p_block = (SpvReflectPrvArenaBlock*)malloc(ArenaBlockHeaderSize() + block_size);
+    if (IsNull(p_block)) {
+      return NULL;
+    }
+    p_block->p_next = p_arena->p_blocks;
+    p_block->size = block_size;
+    p_block->used = 0;
+    p_arena->p_blocks = p_block;
+    p_arena->next_block_size = block_size <= SIZE_MAX / 2 ? block_size * 2 : block_size;
+  }
+
+  char* p_memory = (char*)p_block + ArenaBlockHeaderSize() + p_block->used;
+  p_block->used += bytes;
+  memset(p_memory, 0, bytes);
+  return p_memory;
+}
+
+// Arena memory is only released by DestroyArena()
+#define ArenaSafeFree(p_arena, ptr) \
+  {                                 \
+    if (IsNull(p_arena)) {          \
+      free((void*)ptr);             \
+    }                               \
+    ptr = NULL;                     \
+  }
+
+static void DestroyArena(SpvReflectPrvArena* p_arena) {
+  SpvReflectPrvArenaBlock* p_block = p_arena->p_blocks;
+  while (IsNotNull(p_block)) {
+    SpvReflectPrvArenaBlock* p_next = p_block->p_next;
+    free(p_block);
+    p_block = p_next;
+  }
+  p_arena->p_blocks = NULL;
+}
+
+static SpvReflectPrvArena* GetModuleArena(const SpvReflectShaderModule* p_module) {
+  return (SpvReflectPrvArena*)p_module->_internal->arena;
+}
+
 static int SortCompareUint32(const void* a, const void* b) {
   const uint32_t* p_a = (const uint32_t*)a;
   const uint32_t* p_b = (const uint32_t*)b;
@@ -303,9 +402,9 @@ static bool SearchSortedUint32(const uint32_t* arr, size_t size, uint32_t target
   return false;
 }
 
-static SpvReflectResult IntersectSortedAccessedVariable(const SpvReflectPrvAccessedVariable* p_arr0, size_t arr0_size,
-                                                        const uint32_t* p_arr1, size_t arr1_size, uint32_t** pp_res,
-                                                        size_t* res_size) {
+static SpvReflectResult IntersectSortedAccessedVariable(SpvReflectPrvArena* p_arena, const SpvReflectPrvAccessedVariable* p_arr0,
+                                                        size_t arr0_size, const uint32_t* p_arr1, size_t arr1_size,
+                                                        uint32_t** pp_res, size_t* res_size) {
   *pp_res = NULL;
   *res_size = 0;
   if (IsNull(p_arr0) || IsNull(p_arr1)) {
@@ -330,7 +429,7 @@ static SpvReflectResult IntersectSortedAccessedVariable(const SpvReflectPrvAcces
   }
 
   if (*res_size > 0) {
-    *pp_res = (uint32_t*)calloc(*res_size, sizeof(**pp_res));
+    *pp_res = (uint32_t*)ArenaCalloc(p_arena, *res_size, sizeof(**pp_res));
     if (IsNull(*pp_res)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -509,7 +608,39 @@ static bool IsSpecConstant(const SpvReflectPrvNode* p_node) {
           p_node->op == SpvOpSpecConstantFalse);
 }
 
+// Id lookups are indexed by result id and hold an index into the array being
+// searched, or INVALID_VALUE if nothing uses the id. Ids the lookup can't
+// answer (0, ids past the bound, or no lookup because the allocation failed)
+// fall back to a linear search.
+static uint32_t* CreateIdLookup(SpvReflectPrvArena* p_arena, uint32_t id_bound) {
+  if ((id_bound == 0) || (id_bound > SPIRV_MAX_ID_BOUND)) {
+    return NULL;
+  }
+  uint32_t* p_lookup = IsNull(p_arena) ? (uint32_t*)malloc(id_bound * sizeof(*p_lookup))
+                                       : (uint32_t*)ArenaCalloc(p_arena, id_bound, sizeof(*p_lookup));
+  if (IsNotNull(p_lookup)) {
+    memset(p_lookup, 0xFF, id_bound * sizeof(*p_lookup));
+  }
+  return p_lookup;
+}
+
+static bool HasIdLookup(const uint32_t* p_lookup, uint32_t id_bound, uint32_t id) {
+  return IsNotNull(p_lookup) && (id != 0) && (id < id_bound);
+}
+
+// Only the first user of an id is recorded, which matches the linear search
+static void RegisterId(uint32_t* p_lookup, uint32_t id_bound, uint32_t id, uint32_t index) {
+  if (HasIdLookup(p_lookup, id_bound, id) && (p_lookup[id] == (uint32_t)INVALID_VALUE)) {
+    p_lookup[id] = index;
+  }
+}
+
 static SpvReflectPrvNode* FindNode(SpvReflectPrvParser* p_parser, uint32_t result_id) {
+  if (HasIdLookup(p_parser->node_lookup, p_parser->id_bound, result_id)) {
+    const uint32_t node_index = p_parser->node_lookup[result_id];
+    return (node_index != (uint32_t)INVALID_VALUE) ? &(p_parser->nodes[node_index]) : NULL;
+  }
+
   SpvReflectPrvNode* p_node = NULL;
   for (size_t i = 0; i < p_parser->node_count; ++i) {
     SpvReflectPrvNode* p_elem = &(p_parser->nodes[i]);
@@ -522,6 +653,11 @@ static SpvReflectPrvNode* FindNode(SpvReflectPrvParser* p_parser, uint32_t resul
 }
 
 static SpvReflectTypeDescription* FindType(SpvReflectShaderModule* p_module, uint32_t type_id) {
+  if (HasIdLookup(p_module->_internal->type_description_lookup, p_module->_internal->type_description_id_bound, type_id)) {
+    const uint32_t type_index = p_module->_internal->type_description_lookup[type_id];
+    return (type_index != (uint32_t)INVALID_VALUE) ? &(p_module->_internal->type_descriptions[type_index]) : NULL;
+  }
+
   SpvReflectTypeDescription* p_type = NULL;
   for (size_t i = 0; i < p_module->_internal->type_description_count; ++i) {
     SpvReflectTypeDescription* p_elem = &(p_module->_internal->type_descriptions[i]);
@@ -534,6 +670,11 @@ static SpvReflectTypeDescription* FindType(SpvReflectShaderModule* p_module, uin
 }
 
 static SpvReflectPrvAccessChain* FindAccessChain(SpvReflectPrvParser* p_parser, uint32_t id) {
+  if (HasIdLookup(p_parser->access_chain_lookup, p_parser->id_bound, id)) {
+    const uint32_t ac_index = p_parser->access_chain_lookup[id];
+    return (ac_index != (uint32_t)INVALID_VALUE) ? &p_parser->access_chains[ac_index] : 0;
+  }
+
   const uint32_t ac_count = p_parser->access_chain_count;
   for (uint32_t i = 0; i < ac_count; i++) {
     if (p_parser->access_chains[i].result_id == id) {
@@ -633,6 +774,14 @@ static SpvReflectResult CreateParser(size_t size, void* p_code, SpvReflectPrvPar
 }
 
 static void DestroyParser(SpvReflectPrvParser* p_parser) {
+  if (IsNotNull(p_parser->p_arena)) {
+    DestroyArena(p_parser->p_arena);
+    p_parser->p_arena = NULL;
+    p_parser->nodes = NULL;
+    p_parser->node_count = 0;
+    return;
+  }
+
   if (!IsNull(p_parser->nodes)) {
     // Free nodes
     for (size_t i = 0; i < p_parser->node_count; ++i) {
@@ -645,8 +794,8 @@ static void DestroyParser(SpvReflectPrvParser* p_parser) {
       }
     }
 
-    // Free functions
-    for (size_t i = 0; i < p_parser->function_count; ++i) {
+    // Free functions (not parsed with SPV_REFLECT_MODULE_FLAG_NO_ENTRY_POINTS)
+    for (size_t i = 0; IsNotNull(p_parser->functions) && i < p_parser->function_count; ++i) {
       SafeFree(p_parser->functions[i].parameters);
       SafeFree(p_parser->functions[i].callees);
       SafeFree(p_parser->functions[i].callee_ptrs);
@@ -663,6 +812,8 @@ static void DestroyParser(SpvReflectPrvParser* p_parser) {
     SafeFree(p_parser->source_embedded);
     SafeFree(p_parser->functions);
     SafeFree(p_parser->access_chains);
+    SafeFree(p_parser->node_lookup);
+    SafeFree(p_parser->access_chain_lookup);
 
     if (IsNotNull(p_parser->physical_pointer_structs)) {
       SafeFree(p_parser->physical_pointer_structs);
@@ -698,9 +849,16 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
     return SPV_REFLECT_RESULT_ERROR_SPIRV_UNEXPECTED_EOF;
   }
 
+  // Allocate id lookups, they are filled in as the nodes are parsed
+  p_parser->id_bound = p_spirv[SPIRV_ID_BOUND_WORD_INDEX];
+  p_parser->node_lookup = CreateIdLookup(p_parser->p_arena, p_parser->id_bound);
+  if (p_parser->access_chain_count > 0) {
+    p_parser->access_chain_lookup = CreateIdLookup(p_parser->p_arena, p_parser->id_bound);
+  }
+
   // Allocate nodes
   p_parser->node_count = node_count;
-  p_parser->nodes = (SpvReflectPrvNode*)calloc(p_parser->node_count, sizeof(*(p_parser->nodes)));
+  p_parser->nodes = (SpvReflectPrvNode*)ArenaCalloc(p_parser->p_arena, p_parser->node_count, sizeof(*(p_parser->nodes)));
   if (IsNull(p_parser->nodes)) {
     return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
@@ -726,7 +884,7 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
 
   // Allocate access chain
   if (p_parser->access_chain_count > 0) {
-    p_parser->access_chains = (SpvReflectPrvAccessChain*)calloc(p_parser->access_chain_count, sizeof(*(p_parser->access_chains)));
+    p_parser->access_chains = (SpvReflectPrvAccessChain*)ArenaCalloc(p_parser->p_arena, p_parser->access_chain_count, sizeof(*(p_parser->access_chains)));
     if (IsNull(p_parser->access_chains)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -764,7 +922,7 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
           const char* p_source = (const char*)(p_parser->spirv_code + p_node->word_offset + 4);
 
           const size_t source_len = strlen(p_source);
-          char* p_source_temp = (char*)calloc(source_len + 1, sizeof(char));
+          char* p_source_temp = (char*)ArenaCalloc(p_parser->p_arena, source_len + 1, sizeof(char));
 
           if (IsNull(p_source_temp)) {
             return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
@@ -776,7 +934,7 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
           strcpy(p_source_temp, p_source);
 #endif
 
-          SafeFree(p_parser->source_embedded);
+          ArenaSafeFree(p_parser->p_arena, p_parser->source_embedded);
           p_parser->source_embedded = p_source_temp;
         }
       } break;
@@ -786,7 +944,7 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
 
         const size_t source_len = strlen(p_source);
         const size_t embedded_source_len = strlen(p_parser->source_embedded);
-        char* p_continued_source = (char*)calloc(source_len + embedded_source_len + 1, sizeof(char));
+        char* p_continued_source = (char*)ArenaCalloc(p_parser->p_arena, source_len + embedded_source_len + 1, sizeof(char));
 
         if (IsNull(p_continued_source)) {
           return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
@@ -800,7 +958,7 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
         strcat(p_continued_source, p_source);
 #endif
 
-        SafeFree(p_parser->source_embedded);
+        ArenaSafeFree(p_parser->p_arena, p_parser->source_embedded);
         p_parser->source_embedded = p_continued_source;
       } break;
 
@@ -889,6 +1047,10 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
         SpvReflectPrvNode* p_fwd_node = FindNode(p_parser, result_id);
         if (p_fwd_node) {
           p_fwd_node->result_id = 0;
+          // Let the pointer node take over the id
+          if (HasIdLookup(p_parser->node_lookup, p_parser->id_bound, result_id)) {
+            p_parser->node_lookup[result_id] = (uint32_t)INVALID_VALUE;
+          }
         }
         // Register pointer type
         p_node->result_id = result_id;
@@ -939,13 +1101,14 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
         CHECKED_READU32(p_parser, p_node->word_offset + 1, p_access_chain->result_type_id);
         CHECKED_READU32(p_parser, p_node->word_offset + 2, p_access_chain->result_id);
         CHECKED_READU32(p_parser, p_node->word_offset + 3, p_access_chain->base_id);
+        RegisterId(p_parser->access_chain_lookup, p_parser->id_bound, p_access_chain->result_id, access_chain_index);
         //
         // SPIRV_ACCESS_CHAIN_INDEX_OFFSET (4) is the number of words up until the first index:
         //   [Node, Result Type Id, Result Id, Base Id, <Indexes>]
         //
         p_access_chain->index_count = (node_word_count - SPIRV_ACCESS_CHAIN_INDEX_OFFSET);
         if (p_access_chain->index_count > 0) {
-          p_access_chain->indexes = (uint32_t*)calloc(p_access_chain->index_count, sizeof(*(p_access_chain->indexes)));
+          p_access_chain->indexes = (uint32_t*)ArenaCalloc(p_parser->p_arena, p_access_chain->index_count, sizeof(*(p_access_chain->indexes)));
           if (IsNull(p_access_chain->indexes)) {
             return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
           }
@@ -1009,6 +1172,9 @@ static SpvReflectResult ParseNodes(SpvReflectPrvParser* p_parser) {
       ++(p_parser->type_count);
     }
 
+    // Later nodes can only find this one once it is parsed, same as the linear search
+    RegisterId(p_parser->node_lookup, p_parser->id_bound, p_node->result_id, node_index);
+
     spirv_word_index += node_word_count;
     ++node_index;
   }
@@ -1028,7 +1194,7 @@ static SpvReflectResult ParseStrings(SpvReflectPrvParser* p_parser) {
 
   if (IsNotNull(p_parser) && IsNotNull(p_parser->spirv_code) && IsNotNull(p_parser->nodes)) {
     // Allocate string storage
-    p_parser->strings = (SpvReflectPrvString*)calloc(p_parser->string_count, sizeof(*(p_parser->strings)));
+    p_parser->strings = (SpvReflectPrvString*)ArenaCalloc(p_parser->p_arena, p_parser->string_count, sizeof(*(p_parser->strings)));
 
     uint32_t string_index = 0;
     for (size_t i = 0; i < p_parser->node_count; ++i) {
@@ -1078,7 +1244,7 @@ static SpvReflectResult ParseSource(SpvReflectPrvParser* p_parser, SpvReflectSha
     // Source code
     if (IsNotNull(p_parser->source_embedded)) {
       const size_t source_len = strlen(p_parser->source_embedded);
-      char* p_source = (char*)calloc(source_len + 1, sizeof(char));
+      char* p_source = (char*)ArenaCalloc(GetModuleArena(p_module), source_len + 1, sizeof(char));
 
       if (IsNull(p_source)) {
         return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
@@ -1140,14 +1306,14 @@ static SpvReflectResult ParseFunction(SpvReflectPrvParser* p_parser, SpvReflectP
   }
 
   if (p_func->parameter_count > 0) {
-    p_func->parameters = (uint32_t*)calloc(p_func->parameter_count, sizeof(*(p_func->parameters)));
+    p_func->parameters = (uint32_t*)ArenaCalloc(p_parser->p_arena, p_func->parameter_count, sizeof(*(p_func->parameters)));
     if (IsNull(p_func->parameters)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
   }
 
   if (p_func->callee_count > 0) {
-    p_func->callees = (uint32_t*)calloc(p_func->callee_count, sizeof(*(p_func->callees)));
+    p_func->callees = (uint32_t*)ArenaCalloc(p_parser->p_arena, p_func->callee_count, sizeof(*(p_func->callees)));
     if (IsNull(p_func->callees)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -1155,7 +1321,7 @@ static SpvReflectResult ParseFunction(SpvReflectPrvParser* p_parser, SpvReflectP
 
   if (p_func->accessed_variable_count > 0) {
     p_func->accessed_variables =
-        (SpvReflectPrvAccessedVariable*)calloc(p_func->accessed_variable_count, sizeof(*(p_func->accessed_variables)));
+        (SpvReflectPrvAccessedVariable*)ArenaCalloc(p_parser->p_arena, p_func->accessed_variable_count, sizeof(*(p_func->accessed_variables)));
     if (IsNull(p_func->accessed_variables)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -1260,7 +1426,7 @@ static SpvReflectResult ParseFunctions(SpvReflectPrvParser* p_parser) {
       return SPV_REFLECT_RESULT_SUCCESS;
     }
 
-    p_parser->functions = (SpvReflectPrvFunction*)calloc(p_parser->function_count, sizeof(*(p_parser->functions)));
+    p_parser->functions = (SpvReflectPrvFunction*)ArenaCalloc(p_parser->p_arena, p_parser->function_count, sizeof(*(p_parser->functions)));
     if (IsNull(p_parser->functions)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -1306,7 +1472,7 @@ static SpvReflectResult ParseFunctions(SpvReflectPrvParser* p_parser) {
       if (p_func->callee_count == 0) {
         continue;
       }
-      p_func->callee_ptrs = (SpvReflectPrvFunction**)calloc(p_func->callee_count, sizeof(*(p_func->callee_ptrs)));
+      p_func->callee_ptrs = (SpvReflectPrvFunction**)ArenaCalloc(p_parser->p_arena, p_func->callee_count, sizeof(*(p_func->callee_ptrs)));
       for (size_t j = 0, k = 0; j < p_func->callee_count; ++j) {
         while (p_parser->functions[k].id != p_func->callees[j]) {
           ++k;
@@ -1358,12 +1524,12 @@ static SpvReflectResult ParseMemberCounts(SpvReflectPrvParser* p_parser) {
         continue;
       }
 
-      p_node->member_names = (const char**)calloc(p_node->member_count, sizeof(*(p_node->member_names)));
+      p_node->member_names = (const char**)ArenaCalloc(p_parser->p_arena, p_node->member_count, sizeof(*(p_node->member_names)));
       if (IsNull(p_node->member_names)) {
         return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
       }
 
-      p_node->member_decorations = (SpvReflectPrvDecorations*)calloc(p_node->member_count, sizeof(*(p_node->member_decorations)));
+      p_node->member_decorations = (SpvReflectPrvDecorations*)ArenaCalloc(p_parser->p_arena, p_node->member_count, sizeof(*(p_node->member_decorations)));
       if (IsNull(p_node->member_decorations)) {
         return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
       }
@@ -1719,7 +1885,7 @@ static SpvReflectResult ParseDecorations(SpvReflectPrvParser* p_parser, SpvRefle
   }
 
   if (spec_constant_count > 0) {
-    p_module->spec_constants = (SpvReflectSpecializationConstant*)calloc(spec_constant_count, sizeof(*p_module->spec_constants));
+    p_module->spec_constants = (SpvReflectSpecializationConstant*)ArenaCalloc(GetModuleArena(p_module), spec_constant_count, sizeof(*p_module->spec_constants));
     if (IsNull(p_module->spec_constants)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -1772,7 +1938,7 @@ static SpvReflectResult ParseType(SpvReflectPrvParser* p_parser, SpvReflectPrvNo
   if (p_node->member_count > 0) {
     p_type->struct_type_description = FindType(p_module, p_node->result_id);
     p_type->member_count = p_node->member_count;
-    p_type->members = (SpvReflectTypeDescription*)calloc(p_type->member_count, sizeof(*(p_type->members)));
+    p_type->members = (SpvReflectTypeDescription*)ArenaCalloc(GetModuleArena(p_module), p_type->member_count, sizeof(*(p_type->members)));
     if (IsNotNull(p_type->members)) {
       // Mark all members types with an invalid state
       for (size_t i = 0; i < p_type->members->member_count; ++i) {
@@ -1793,6 +1959,13 @@ static SpvReflectResult ParseType(SpvReflectPrvParser* p_parser, SpvReflectPrvNo
       p_type->id = p_node->result_id;
       p_type->op = p_node->op;
       p_type->decoration_flags = 0;
+
+      // Top level types become visible to FindType() as soon as they have an id
+      SpvReflectTypeDescription* p_types = p_module->_internal->type_descriptions;
+      if ((p_type >= p_types) && (p_type < p_types + p_module->_internal->type_description_count)) {
+        RegisterId(p_module->_internal->type_description_lookup, p_module->_internal->type_description_id_bound, p_type->id,
+                   (uint32_t)(p_type - p_types));
+      }
     }
     // Top level types need to pick up decorations from all types below it.
     // Issue and fix here: https://github.com/chaoticbob/SPIRV-Reflect/issues/64
@@ -2047,11 +2220,13 @@ static SpvReflectResult ParseTypes(SpvReflectPrvParser* p_parser, SpvReflectShad
   }
 
   p_module->_internal->type_description_count = p_parser->type_count;
-  p_module->_internal->type_descriptions = (SpvReflectTypeDescription*)calloc(p_module->_internal->type_description_count,
+  p_module->_internal->type_descriptions = (SpvReflectTypeDescription*)ArenaCalloc(GetModuleArena(p_module), p_module->_internal->type_description_count,
                                                                               sizeof(*(p_module->_internal->type_descriptions)));
   if (IsNull(p_module->_internal->type_descriptions)) {
     return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
+  p_module->_internal->type_description_id_bound = p_parser->id_bound;
+  p_module->_internal->type_description_lookup = CreateIdLookup(GetModuleArena(p_module), p_parser->id_bound);
 
   // Mark all types with an invalid state
   for (size_t i = 0; i < p_module->_internal->type_description_count; ++i) {
@@ -2079,7 +2254,7 @@ static SpvReflectResult ParseTypes(SpvReflectPrvParser* p_parser, SpvReflectShad
 
   // allocate now and fill in when parsing struct variable later
   if (p_parser->physical_pointer_struct_count > 0) {
-    p_parser->physical_pointer_structs = (SpvReflectPrvPhysicalPointerStruct*)calloc(p_parser->physical_pointer_struct_count,
+    p_parser->physical_pointer_structs = (SpvReflectPrvPhysicalPointerStruct*)ArenaCalloc(p_parser->p_arena, p_parser->physical_pointer_struct_count,
                                                                                      sizeof(*(p_parser->physical_pointer_structs)));
     if (IsNull(p_parser->physical_pointer_structs)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
@@ -2094,7 +2269,7 @@ static SpvReflectResult ParseCapabilities(SpvReflectPrvParser* p_parser, SpvRefl
   }
 
   p_module->capability_count = p_parser->capability_count;
-  p_module->capabilities = (SpvReflectCapability*)calloc(p_module->capability_count, sizeof(*(p_module->capabilities)));
+  p_module->capabilities = (SpvReflectCapability*)ArenaCalloc(GetModuleArena(p_module), p_module->capability_count, sizeof(*(p_module->capabilities)));
   if (IsNull(p_module->capabilities)) {
     return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
@@ -2156,7 +2331,7 @@ static SpvReflectResult ParseDescriptorBindings(SpvReflectPrvParser* p_parser, S
   }
 
   p_module->descriptor_bindings =
-      (SpvReflectDescriptorBinding*)calloc(p_module->descriptor_binding_count, sizeof(*(p_module->descriptor_bindings)));
+      (SpvReflectDescriptorBinding*)ArenaCalloc(GetModuleArena(p_module), p_module->descriptor_binding_count, sizeof(*(p_module->descriptor_bindings)));
   if (IsNull(p_module->descriptor_bindings)) {
     return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
@@ -2487,7 +2662,7 @@ static SpvReflectResult ParseDescriptorBlockVariable(SpvReflectPrvParser* p_pars
 
   if (IsNotNull(p_type->members) && (p_type->member_count > 0)) {
     p_var->member_count = p_type->member_count;
-    p_var->members = (SpvReflectBlockVariable*)calloc(p_var->member_count, sizeof(*p_var->members));
+    p_var->members = (SpvReflectBlockVariable*)ArenaCalloc(GetModuleArena(p_module), p_var->member_count, sizeof(*p_var->members));
     if (IsNull(p_var->members)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -3160,7 +3335,7 @@ static SpvReflectResult ParseInterfaceVariable(SpvReflectPrvParser* p_parser,
 
   if (p_type->member_count > 0) {
     p_var->member_count = p_type->member_count;
-    p_var->members = (SpvReflectInterfaceVariable*)calloc(p_var->member_count, sizeof(*p_var->members));
+    p_var->members = (SpvReflectInterfaceVariable*)ArenaCalloc(GetModuleArena(p_module), p_var->member_count, sizeof(*p_var->members));
     if (IsNull(p_var->members)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -3240,7 +3415,7 @@ static SpvReflectResult ParseInterfaceVariables(SpvReflectPrvParser* p_parser, S
 
   if (p_entry->input_variable_count > 0) {
     p_entry->input_variables =
-        (SpvReflectInterfaceVariable**)calloc(p_entry->input_variable_count, sizeof(*(p_entry->input_variables)));
+        (SpvReflectInterfaceVariable**)ArenaCalloc(GetModuleArena(p_module), p_entry->input_variable_count, sizeof(*(p_entry->input_variables)));
     if (IsNull(p_entry->input_variables)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -3248,7 +3423,7 @@ static SpvReflectResult ParseInterfaceVariables(SpvReflectPrvParser* p_parser, S
 
   if (p_entry->output_variable_count > 0) {
     p_entry->output_variables =
-        (SpvReflectInterfaceVariable**)calloc(p_entry->output_variable_count, sizeof(*(p_entry->output_variables)));
+        (SpvReflectInterfaceVariable**)ArenaCalloc(GetModuleArena(p_module), p_entry->output_variable_count, sizeof(*(p_entry->output_variables)));
     if (IsNull(p_entry->output_variables)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -3256,7 +3431,7 @@ static SpvReflectResult ParseInterfaceVariables(SpvReflectPrvParser* p_parser, S
 
   if (p_entry->interface_variable_count > 0) {
     p_entry->interface_variables =
-        (SpvReflectInterfaceVariable*)calloc(p_entry->interface_variable_count, sizeof(*(p_entry->interface_variables)));
+        (SpvReflectInterfaceVariable*)ArenaCalloc(GetModuleArena(p_module), p_entry->interface_variable_count, sizeof(*(p_entry->interface_variables)));
     if (IsNull(p_entry->interface_variables)) {
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -3595,16 +3770,16 @@ static SpvReflectResult ParseStaticallyUsedResources(SpvReflectPrvParser* p_pars
 
   // Do set intersection to find the used uniform and push constants
   size_t used_uniform_count = 0;
-  result = IntersectSortedAccessedVariable(p_used_accesses, used_acessed_count, uniforms, uniform_count, &p_entry->used_uniforms,
-                                           &used_uniform_count);
+  result = IntersectSortedAccessedVariable(GetModuleArena(p_module), p_used_accesses, used_acessed_count, uniforms, uniform_count,
+                                           &p_entry->used_uniforms, &used_uniform_count);
   if (result != SPV_REFLECT_RESULT_SUCCESS) {
     SafeFree(p_used_accesses);
     return result;
   }
 
   size_t used_push_constant_count = 0;
-  result = IntersectSortedAccessedVariable(p_used_accesses, used_acessed_count, push_constants, push_constant_count,
-                                           &p_entry->used_push_constants, &used_push_constant_count);
+  result = IntersectSortedAccessedVariable(GetModuleArena(p_module), p_used_accesses, used_acessed_count, push_constants,
+                                           push_constant_count, &p_entry->used_push_constants, &used_push_constant_count);
   if (result != SPV_REFLECT_RESULT_SUCCESS) {
     SafeFree(p_used_accesses);
     return result;
@@ -3642,13 +3817,13 @@ static SpvReflectResult ParseStaticallyUsedResources(SpvReflectPrvParser* p_pars
         // offsets and then de-duplicate it
         uint32_t* prev_byte_address_buffer_offsets = p_binding->byte_address_buffer_offsets;
         p_binding->byte_address_buffer_offsets =
-            (uint32_t*)calloc(byte_address_buffer_offset_count + p_binding->byte_address_buffer_offset_count, sizeof(uint32_t));
+            (uint32_t*)ArenaCalloc(GetModuleArena(p_module), byte_address_buffer_offset_count + p_binding->byte_address_buffer_offset_count, sizeof(uint32_t));
         memcpy(p_binding->byte_address_buffer_offsets, prev_byte_address_buffer_offsets,
                sizeof(uint32_t) * p_binding->byte_address_buffer_offset_count);
-        SafeFree(prev_byte_address_buffer_offsets);
+        ArenaSafeFree(GetModuleArena(p_module), prev_byte_address_buffer_offsets);
       } else {
         // possible not all allocated offset slots are used, but this will be a max per binding
-        p_binding->byte_address_buffer_offsets = (uint32_t*)calloc(byte_address_buffer_offset_count, sizeof(uint32_t));
+        p_binding->byte_address_buffer_offsets = (uint32_t*)ArenaCalloc(GetModuleArena(p_module), byte_address_buffer_offset_count, sizeof(uint32_t));
       }
 
       if (IsNull(p_binding->byte_address_buffer_offsets)) {
@@ -3689,7 +3864,7 @@ static SpvReflectResult ParseEntryPoints(SpvReflectPrvParser* p_parser, SpvRefle
   }
 
   p_module->entry_point_count = p_parser->entry_point_count;
-  p_module->entry_points = (SpvReflectEntryPoint*)calloc(p_module->entry_point_count, sizeof(*(p_module->entry_points)));
+  p_module->entry_points = (SpvReflectEntryPoint*)ArenaCalloc(GetModuleArena(p_module), p_module->entry_point_count, sizeof(*(p_module->entry_points)));
   if (IsNull(p_module->entry_points)) {
     return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
@@ -3911,7 +4086,7 @@ static SpvReflectResult ParseExecutionModes(SpvReflectPrvParser* p_parser, SpvRe
       SpvReflectEntryPoint* p_entry_point = &p_module->entry_points[entry_point_idx];
       if (p_entry_point->execution_mode_count > 0) {
         p_entry_point->execution_modes =
-            (SpvExecutionMode*)calloc(p_entry_point->execution_mode_count, sizeof(*p_entry_point->execution_modes));
+            (SpvExecutionMode*)ArenaCalloc(GetModuleArena(p_module), p_entry_point->execution_mode_count, sizeof(*p_entry_point->execution_modes));
         if (IsNull(p_entry_point->execution_modes)) {
           SafeFree(indices);
           return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
@@ -3965,7 +4140,7 @@ static SpvReflectResult ParsePushConstantBlocks(SpvReflectPrvParser* p_parser, S
   }
 
   p_module->push_constant_blocks =
-      (SpvReflectBlockVariable*)calloc(p_module->push_constant_block_count, sizeof(*p_module->push_constant_blocks));
+      (SpvReflectBlockVariable*)ArenaCalloc(GetModuleArena(p_module), p_module->push_constant_block_count, sizeof(*p_module->push_constant_blocks));
   if (IsNull(p_module->push_constant_blocks)) {
     return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
   }
@@ -4058,9 +4233,9 @@ static SpvReflectResult ParseEntrypointDescriptorSets(SpvReflectShaderModule* p_
   for (uint32_t i = 0; i < p_module->entry_point_count; ++i) {
     SpvReflectEntryPoint* p_entry = &p_module->entry_points[i];
     for (uint32_t j = 0; j < p_entry->descriptor_set_count; ++j) {
-      SafeFree(p_entry->descriptor_sets[j].bindings);
+      ArenaSafeFree(GetModuleArena(p_module), p_entry->descriptor_sets[j].bindings);
     }
-    SafeFree(p_entry->descriptor_sets);
+    ArenaSafeFree(GetModuleArena(p_module), p_entry->descriptor_sets);
     p_entry->descriptor_set_count = 0;
     for (uint32_t j = 0; j < p_module->descriptor_set_count; ++j) {
       const SpvReflectDescriptorSet* p_set = &p_module->descriptor_sets[j];
@@ -4075,7 +4250,7 @@ static SpvReflectResult ParseEntrypointDescriptorSets(SpvReflectShaderModule* p_
 
     p_entry->descriptor_sets = NULL;
     if (p_entry->descriptor_set_count > 0) {
-      p_entry->descriptor_sets = (SpvReflectDescriptorSet*)calloc(p_entry->descriptor_set_count, sizeof(*p_entry->descriptor_sets));
+      p_entry->descriptor_sets = (SpvReflectDescriptorSet*)ArenaCalloc(GetModuleArena(p_module), p_entry->descriptor_set_count, sizeof(*p_entry->descriptor_sets));
       if (IsNull(p_entry->descriptor_sets)) {
         return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
       }
@@ -4095,7 +4270,7 @@ static SpvReflectResult ParseEntrypointDescriptorSets(SpvReflectShaderModule* p_
       }
       SpvReflectDescriptorSet* p_entry_set = &p_entry->descriptor_sets[p_entry->descriptor_set_count++];
       p_entry_set->set = p_set->set;
-      p_entry_set->bindings = (SpvReflectDescriptorBinding**)calloc(count, sizeof(*p_entry_set->bindings));
+      p_entry_set->bindings = (SpvReflectDescriptorBinding**)ArenaCalloc(GetModuleArena(p_module), count, sizeof(*p_entry_set->bindings));
       if (IsNull(p_entry_set->bindings)) {
         return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
       }
@@ -4162,7 +4337,7 @@ static SpvReflectResult ParseDescriptorSets(SpvReflectShaderModule* p_module) {
   // Build descriptor pointer array
   for (uint32_t i = 0; i < p_module->descriptor_set_count; ++i) {
     SpvReflectDescriptorSet* p_set = &(p_module->descriptor_sets[i]);
-    p_set->bindings = (SpvReflectDescriptorBinding**)calloc(p_set->binding_count, sizeof(*(p_set->bindings)));
+    p_set->bindings = (SpvReflectDescriptorBinding**)ArenaCalloc(GetModuleArena(p_module), p_set->binding_count, sizeof(*(p_set->bindings)));
 
     uint32_t descriptor_index = 0;
     for (uint32_t j = 0; j < p_module->descriptor_binding_count; ++j) {
@@ -4208,7 +4383,7 @@ static SpvReflectResult SynchronizeDescriptorSets(SpvReflectShaderModule* p_modu
   // Free and reset all descriptor set numbers
   for (uint32_t i = 0; i < SPV_REFLECT_MAX_DESCRIPTOR_SETS; ++i) {
     SpvReflectDescriptorSet* p_set = &p_module->descriptor_sets[i];
-    SafeFree(p_set->bindings);
+    ArenaSafeFree(GetModuleArena(p_module), p_set->bindings);
     p_set->binding_count = 0;
     p_set->set = (uint32_t)INVALID_VALUE;
   }
@@ -4234,6 +4409,13 @@ static SpvReflectResult CreateShaderModule(uint32_t flags, size_t size, const vo
   }
   // Copy flags
   p_module->_internal->module_flags = flags;
+  if (flags & SPV_REFLECT_MODULE_FLAG_ARENA) {
+    p_module->_internal->arena = calloc(1, sizeof(SpvReflectPrvArena));
+    if (IsNull(p_module->_internal->arena)) {
+      SafeFree(p_module->_internal);
+      return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
+    }
+  }
   // Figure out if we need to copy the SPIR-V code or not
   if (flags & SPV_REFLECT_MODULE_FLAG_NO_COPY) {
     // Set internal size and pointer to args passed in
@@ -4250,6 +4432,7 @@ static SpvReflectResult CreateShaderModule(uint32_t flags, size_t size, const vo
     p_module->_internal->spirv_code = (uint32_t*)calloc(1, p_module->_internal->spirv_size);
     p_module->_internal->spirv_word_count = (uint32_t)(size / SPIRV_WORD_SIZE);
     if (IsNull(p_module->_internal->spirv_code)) {
+      SafeFree(p_module->_internal->arena);
       SafeFree(p_module->_internal);
       return SPV_REFLECT_RESULT_ERROR_ALLOC_FAILED;
     }
@@ -4260,6 +4443,13 @@ static SpvReflectResult CreateShaderModule(uint32_t flags, size_t size, const vo
   // Initialize everything to zero
   SpvReflectPrvParser parser;
   memset(&parser, 0, sizeof(SpvReflectPrvParser));
+  if (flags & SPV_REFLECT_MODULE_FLAG_ARENA) {
+    // The parser is gone once the module is created, so it gets its own arena
+    // and the module's only holds what the module keeps
+    parser.p_arena = &parser.arena;
+    parser.arena.next_block_size = size;
+    GetModuleArena(p_module)->next_block_size = size / 4;
+  }
 
   // Create parser
   SpvReflectResult result = CreateParser(p_module->_internal->spirv_size, p_module->_internal->spirv_code, &parser);
@@ -4274,15 +4464,19 @@ static SpvReflectResult CreateShaderModule(uint32_t flags, size_t size, const vo
     result = ParseNodes(&parser);
     SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+  const bool parse_source = (flags & SPV_REFLECT_MODULE_FLAG_NO_SOURCE) == 0;
+  const bool parse_entry_points = (flags & SPV_REFLECT_MODULE_FLAG_NO_ENTRY_POINTS) == 0;
+
+  if (result == SPV_REFLECT_RESULT_SUCCESS && parse_source) {
     result = ParseStrings(&parser);
     SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+  if (result == SPV_REFLECT_RESULT_SUCCESS && parse_source) {
     result = ParseSource(&parser, p_module);
     SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+  // Functions are only needed to find the resources statically used by each entry point
+  if (result == SPV_REFLECT_RESULT_SUCCESS && parse_entry_points) {
     result = ParseFunctions(&parser);
     SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
   }
@@ -4336,7 +4530,7 @@ static SpvReflectResult CreateShaderModule(uint32_t flags, size_t size, const vo
     result = ParsePushConstantBlocks(&parser, p_module);
     SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+  if (result == SPV_REFLECT_RESULT_SUCCESS && parse_entry_points) {
     result = ParseEntryPoints(&parser, p_module);
     SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
   }
@@ -4365,7 +4559,7 @@ static SpvReflectResult CreateShaderModule(uint32_t flags, size_t size, const vo
     result = SynchronizeDescriptorSets(p_module);
     SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
   }
-  if (result == SPV_REFLECT_RESULT_SUCCESS) {
+  if (result == SPV_REFLECT_RESULT_SUCCESS && parse_entry_points) {
     result = ParseExecutionModes(&parser, p_module);
     SPV_REFLECT_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS);
   }
@@ -4450,6 +4644,17 @@ void spvReflectDestroyShaderModule(SpvReflectShaderModule* p_module) {
     return;
   }
 
+  // Everything but the internals and the SPIR-V copy lives in the arena
+  if (IsNotNull(p_module->_internal->arena)) {
+    DestroyArena(GetModuleArena(p_module));
+    SafeFree(p_module->_internal->arena);
+    if ((p_module->_internal->module_flags & SPV_REFLECT_MODULE_FLAG_NO_COPY) == 0) {
+      SafeFree(p_module->_internal->spirv_code);
+    }
+    SafeFree(p_module->_internal);
+    return;
+  }
+
   SafeFree(p_module->source_source);
 
   // Descriptor set bindings
@@ -4504,6 +4709,7 @@ void spvReflectDestroyShaderModule(SpvReflectShaderModule* p_module) {
     SafeFree(p_type->members);
   }
   SafeFree(p_module->_internal->type_descriptions);
+  SafeFree(p_module->_internal->type_description_lookup);
 
   // Free SPIR-V code if there was a copy
   if ((p_module->_internal->module_flags & SPV_REFLECT_MODULE_FLAG_NO_COPY) == 0) {
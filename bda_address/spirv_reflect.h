@@ -94,10 +94,32 @@ SPV_REFLECT_MODULE_FLAG_NO_COPY - Disables copying of SPIR-V code
   This is flag is intended for cases where the memory overhead of
   storing the copied SPIR-V is undesirable.
 
+SPV_REFLECT_MODULE_FLAG_NO_SOURCE - Skips the OpString and OpSource
+  stages. source_file and source_source are left NULL.
+
+SPV_REFLECT_MODULE_FLAG_NO_ENTRY_POINTS - Skips the function,
+  entry point, interface variable and execution mode stages.
+  entry_points is left empty, so only the module level queries
+  (descriptor bindings, descriptor sets, push constant blocks)
+  are available. Use spvReflectGetPushConstantBlock or
+  spvReflectEnumeratePushConstantBlocks instead of the entry
+  point variants.
+
+SPV_REFLECT_MODULE_FLAG_ARENA - Everything the module and the parser
+  allocate comes out of two bump arenas, so creation does a few
+  large allocations and spvReflectDestroyShaderModule frees a
+  handful of blocks instead of walking every type, block variable
+  and interface variable. Functions that rebuild parts of the module
+  afterwards (e.g. spvReflectChangeDescriptorBindingNumbers) only
+  release the old memory when the module is destroyed.
+
 */
 typedef enum SpvReflectModuleFlagBits {
-  SPV_REFLECT_MODULE_FLAG_NONE    = 0x00000000,
-  SPV_REFLECT_MODULE_FLAG_NO_COPY = 0x00000001,
+  SPV_REFLECT_MODULE_FLAG_NONE            = 0x00000000,
+  SPV_REFLECT_MODULE_FLAG_NO_COPY         = 0x00000001,
+  SPV_REFLECT_MODULE_FLAG_NO_SOURCE       = 0x00000002,
+  SPV_REFLECT_MODULE_FLAG_NO_ENTRY_POINTS = 0x00000004,
+  SPV_REFLECT_MODULE_FLAG_ARENA           = 0x00000008,
 } SpvReflectModuleFlagBits;
 
 typedef uint32_t SpvReflectModuleFlags;
@@ -621,6 +643,13 @@ typedef struct SpvReflectShaderModule {
 
     size_t                          type_description_count;
     SpvReflectTypeDescription*      type_descriptions;
+
+    // Type id -> index into type_descriptions
+    uint32_t                        type_description_id_bound;
+    uint32_t*                       type_description_lookup;
+
+    // SpvReflectPrvArena with SPV_REFLECT_MODULE_FLAG_ARENA, NULL otherwise
+    void*                           arena;
   } * _internal;
 
 } SpvReflectShaderModule;
@@ -0,0 +1,273 @@
+#include <iostream>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "spirv_batch.h"
+#include "spirv_file.h"
+#include "spirv_instruction.h"
+#include "spirv_parsing_util.h"
+#include "spirv_reflect.h"
+#include "spirv_scanner.h"
+#include "vertex_input_position_analyzer.h"
+
+// Every phase is timed on its own, per module and iteration.
+// load maps the file and reads every page of it, so the I/O isn't charged to whichever phase touches it first.
+// The BDA pass is split into its two steps: bda_decode builds its instruction table with the definitions and sizes
+// its indices, bda_track_back is everything after that. vertex_analyze includes its own decode. The format phases
+// print the last result to the null device.
+enum Phase {
+    PHASE_LOAD = 0,
+    PHASE_SCAN,
+    PHASE_DECODE,
+    PHASE_REFLECT,
+    PHASE_BDA_DECODE,
+    PHASE_BDA_TRACK_BACK,
+    PHASE_BDA_FORMAT,
+    PHASE_VERTEX_ANALYZE,
+    PHASE_VERTEX_FORMAT,
+    PHASE_COUNT
+};
+
+static const char* kPhaseNames[PHASE_COUNT] = {
+    "load",           "scan",       "decode",         "reflect",       "bda_decode",
+    "bda_track_back", "bda_format", "vertex_analyze", "vertex_format",
+};
+
+// a word per page is enough to fault every page of a mapping in
+constexpr size_t kWordsPerPage = 4096 / sizeof(uint32_t);
+
+struct PhaseSamples {
+    std::vector<double> durations_ns;
+    size_t num_bytes = 0;
+};
+
+struct PhaseStats {
+    size_t num_samples = 0;
+    double total_ms = 0.0;
+    double mean_us = 0.0;
+    double min_us = 0.0;
+    double p50_us = 0.0;
+    double p90_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+    double megabytes_per_second = 0.0;
+    double modules_per_second = 0.0;
+};
+
+template <typename Function>
+double TimeNs(Function&& function) {
+    auto start_time = std::chrono::steady_clock::now();
+    function();
+    auto end_time = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end_time - start_time).count();
+}
+
+// nearest-rank percentile of sorted samples
+double Percentile(const std::vector<double>& sorted, double percentile) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const size_t rank = static_cast<size_t>(percentile / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+PhaseStats ComputeStats(const PhaseSamples& samples) {
+    PhaseStats stats;
+    std::vector<double> sorted = samples.durations_ns;
+    std::sort(sorted.begin(), sorted.end());
+    stats.num_samples = sorted.size();
+    if (sorted.empty()) {
+        return stats;
+    }
+
+    double total_ns = 0.0;
+    for (double duration_ns : sorted) {
+        total_ns += duration_ns;
+    }
+    stats.total_ms = total_ns / 1e6;
+    stats.mean_us = total_ns / static_cast<double>(sorted.size()) / 1e3;
+    stats.min_us = sorted.front() / 1e3;
+    stats.p50_us = Percentile(sorted, 50.0) / 1e3;
+    stats.p90_us = Percentile(sorted, 90.0) / 1e3;
+    stats.p99_us = Percentile(sorted, 99.0) / 1e3;
+    stats.max_us = sorted.back() / 1e3;
+    if (total_ns > 0.0) {
+        const double seconds = total_ns / 1e9;
+        stats.megabytes_per_second = static_cast<double>(samples.num_bytes) / (1024.0 * 1024.0) / seconds;
+        stats.modules_per_second = static_cast<double>(sorted.size()) / seconds;
+    }
+    return stats;
+}
+
+void WriteJson(FILE* out, const PhaseStats (&stats)[PHASE_COUNT], size_t num_modules, size_t corpus_bytes,
+               int iterations) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"format_version\": 2,\n");
+    fprintf(out, "  \"simd\": \"%s\",\n", SpirVScanner::GetSimdLevel());
+    fprintf(out, "  \"modules\": %zu,\n", num_modules);
+    fprintf(out, "  \"corpus_bytes\": %zu,\n", corpus_bytes);
+    fprintf(out, "  \"iterations\": %d,\n", iterations);
+    fprintf(out, "  \"phases\": [\n");
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        const PhaseStats& s = stats[phase];
+        fprintf(out,
+                "    {\"name\": \"%s\", \"samples\": %zu, \"total_ms\": %.3f, \"mean_us\": %.3f, \"min_us\": %.3f, "
+                "\"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, \"mb_per_s\": %.2f, "
+                "\"modules_per_s\": %.1f}%s\n",
+                kPhaseNames[phase], s.num_samples, s.total_ms, s.mean_us, s.min_us, s.p50_us, s.p90_us, s.p99_us,
+                s.max_us, s.megabytes_per_second, s.modules_per_second, phase + 1 < PHASE_COUNT ? "," : "");
+    }
+    fprintf(out, "  ]\n");
+    fprintf(out, "}\n");
+}
+
+int main(int argc, char** argv) {
+    int iterations = 10;
+    int warmup_iterations = 1;
+    std::string json_path;
+    SpirVBatch batch;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            warmup_iterations = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (arg == "--manifest" && i + 1 < argc) {
+            if (!batch.AddManifest(argv[++i])) {
+                std::cout << "ERROR: Unable to read the manifest " << argv[i] << "\n";
+                return EXIT_FAILURE;
+            }
+        } else if (!batch.AddInput(arg)) {
+            std::cout << "ERROR: " << arg << " Does not exists\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (batch.files().empty()) {
+        std::cout << "Usage:\n\t" << argv[0]
+                  << " [--iterations N] [--warmup N] [--json out.json] [--manifest list.txt] (input.spv | directory)...\n";
+        return EXIT_FAILURE;
+    }
+
+#ifdef _WIN32
+    FILE* null_output = fopen("NUL", "w");
+#else
+    FILE* null_output = fopen("/dev/null", "w");
+#endif
+    if (!null_output) {
+        std::cout << "ERROR: Unable to open the null device\n";
+        return EXIT_FAILURE;
+    }
+
+    // same reuse as the tools: one of everything for the whole run
+    SpirVFile spirv;
+    SpirVInstructionTable instructions;
+    SpirVParsingUtil parsing_util;
+    parsing_util.SetOutput(null_output);
+    VertexInputPositionAnalyzer vertex_analyzer;
+
+    PhaseSamples samples[PHASE_COUNT];
+    size_t corpus_bytes = 0;
+    size_t num_modules = 0;
+    // keeps the page reads of the load phase from being optimized away
+    volatile uint32_t page_checksum = 0;
+
+    for (int iteration = 0; iteration < warmup_iterations + iterations; iteration++) {
+        const bool record = iteration >= warmup_iterations;
+        for (const std::string& input_path : batch.files()) {
+            bool loaded = false;
+            const double load_ns = TimeNs([&] {
+                loaded = spirv.Open(input_path.c_str());
+                uint32_t checksum = 0;
+                for (size_t i = 0; loaded && i < spirv.num_words(); i += kWordsPerPage) {
+                    checksum += spirv.data()[i];
+                }
+                page_checksum = page_checksum + checksum;
+            });
+            if (!loaded || spirv.num_words() < SpirVScanner::kHeaderSize) {
+                if (iteration == 0) {
+                    std::cout << "WARNING: skipping " << input_path << ", unable to load it\n";
+                }
+                continue;
+            }
+
+            const uint32_t* code = spirv.data();
+            const size_t size = spirv.size_bytes();
+            double durations_ns[PHASE_COUNT] = {};
+            durations_ns[PHASE_LOAD] = load_ns;
+
+            durations_ns[PHASE_SCAN] = TimeNs([&] { (void)SpirVScanner::Scan(code, size); });
+            durations_ns[PHASE_DECODE] = TimeNs([&] { (void)instructions.Build(code, size); });
+
+            durations_ns[PHASE_REFLECT] = TimeNs([&] {
+                constexpr SpvReflectModuleFlags reflect_flags = SPV_REFLECT_MODULE_FLAG_NO_COPY |
+                                                                SPV_REFLECT_MODULE_FLAG_NO_SOURCE |
+                                                                SPV_REFLECT_MODULE_FLAG_NO_ENTRY_POINTS |
+                                                                SPV_REFLECT_MODULE_FLAG_ARENA;
+                SpvReflectShaderModule module = {};
+                if (spvReflectCreateShaderModule2(reflect_flags, size, code, &module) == SPV_REFLECT_RESULT_SUCCESS) {
+                    spvReflectDestroyShaderModule(&module);
+                }
+            });
+
+            bool decoded = false;
+            durations_ns[PHASE_BDA_DECODE] = TimeNs([&] { decoded = parsing_util.DecodeModule(code, size); });
+            durations_ns[PHASE_BDA_TRACK_BACK] = TimeNs([&] {
+                if (decoded) {
+                    (void)parsing_util.TrackBackBufferReferences();
+                }
+            });
+            durations_ns[PHASE_BDA_FORMAT] = TimeNs([&] { parsing_util.PrintBufferReferences(); });
+
+            durations_ns[PHASE_VERTEX_ANALYZE] = TimeNs([&] { (void)vertex_analyzer.Analyze(code, size); });
+            durations_ns[PHASE_VERTEX_FORMAT] = TimeNs([&] { vertex_analyzer.PrintResult(null_output); });
+
+            if (!record) {
+                continue;
+            }
+            for (int phase = 0; phase < PHASE_COUNT; phase++) {
+                samples[phase].durations_ns.push_back(durations_ns[phase]);
+                samples[phase].num_bytes += size;
+            }
+            if (iteration == warmup_iterations) {
+                corpus_bytes += size;
+                num_modules++;
+            }
+        }
+    }
+    spirv.Close();
+    fclose(null_output);
+
+    PhaseStats stats[PHASE_COUNT];
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        stats[phase] = ComputeStats(samples[phase]);
+    }
+
+    printf("Modules = %zu, Size = %.2f MB, Iterations = %d, SIMD = %s\n", num_modules,
+           static_cast<double>(corpus_bytes) / (1024.0 * 1024.0), iterations, SpirVScanner::GetSimdLevel());
+    printf("%-16s %10s %10s %10s %10s %10s %10s %12s %12s\n", "phase", "mean us", "min us", "p50 us", "p90 us",
+           "p99 us", "max us", "MB/s", "modules/s");
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        const PhaseStats& s = stats[phase];
+        printf("%-16s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f %12.2f %12.1f\n", kPhaseNames[phase], s.mean_us,
+               s.min_us, s.p50_us, s.p90_us, s.p99_us, s.max_us, s.megabytes_per_second, s.modules_per_second);
+    }
+
+    if (!json_path.empty()) {
+        FILE* json_file = fopen(json_path.c_str(), "w");
+        if (!json_file) {
+            std::cout << "ERROR: Unable to write " << json_path << "\n";
+            return EXIT_FAILURE;
+        }
+        WriteJson(json_file, stats, num_modules, corpus_bytes, iterations);
+        fclose(json_file);
+    }
+    return 0;
+}
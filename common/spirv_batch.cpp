@@ -0,0 +1,183 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_batch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SPIRV_BATCH_USE_MEMSTREAM 1
+#endif
+
+bool SpirVBatch::AddInput(const std::string& path)
+{
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error))
+    {
+        // increment(error) rather than ++, which throws when an entry can't be read halfway through the walk.
+        // Directories we may not read are skipped, any other failure ends the walk with what was found so far
+        std::vector<std::string> directory_files;
+        std::filesystem::recursive_directory_iterator it(
+            path, std::filesystem::directory_options::skip_permission_denied, error);
+        for (; !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+        {
+            std::error_code entry_error;
+            if (it->is_regular_file(entry_error) && it->path().extension() == ".spv")
+            {
+                directory_files.push_back(it->path().string());
+            }
+        }
+        std::sort(directory_files.begin(), directory_files.end());
+        files_.insert(files_.end(), directory_files.begin(), directory_files.end());
+        is_batch_ = true;
+        return !error;
+    }
+
+    if (!std::filesystem::exists(path, error))
+    {
+        return false;
+    }
+    files_.push_back(path);
+    return true;
+}
+
+bool SpirVBatch::AddManifest(const std::string& manifest_path)
+{
+    std::ifstream manifest(manifest_path);
+    if (!manifest)
+    {
+        return false;
+    }
+
+    const std::filesystem::path base_directory = std::filesystem::path(manifest_path).parent_path();
+
+    std::string line;
+    while (std::getline(manifest, line))
+    {
+        // tolerate manifests written on Windows
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        const std::filesystem::path path(line);
+        files_.push_back(path.is_relative() ? (base_directory / path).string() : line);
+    }
+    is_batch_ = true;
+    return true;
+}
+
+std::vector<size_t> SpirVBatch::LargestFirstOrder() const
+{
+    std::vector<uintmax_t> sizes(files_.size(), 0);
+    for (size_t i = 0; i < files_.size(); i++)
+    {
+        std::error_code error;
+        const uintmax_t size = std::filesystem::file_size(files_[i], error);
+        sizes[i]             = error ? 0 : size;
+    }
+
+    std::vector<size_t> order(files_.size());
+    std::iota(order.begin(), order.end(), 0);
+    // stable, so files of equal size keep their input order
+    std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+    return order;
+}
+
+void SpirVBatch::PrintStats(const Stats& stats, FILE* out)
+{
+    const double megabytes = static_cast<double>(stats.num_bytes) / (1024.0 * 1024.0);
+    const double seconds   = stats.duration_ms / 1000.0;
+
+    fprintf(out,
+            "Modules = %zu (%zu failed), Size = %.2f MB, Time = %.3f ms\n",
+            stats.num_modules,
+            stats.num_failed,
+            megabytes,
+            stats.duration_ms);
+    if (seconds > 0.0)
+    {
+        fprintf(out,
+                "Throughput = %.2f MB/s, %.1f modules/s\n",
+                megabytes / seconds,
+                static_cast<double>(stats.num_modules) / seconds);
+    }
+    if (stats.num_cached > 0)
+    {
+        fprintf(out, "Cache hits = %zu of %zu modules\n", stats.num_cached, stats.num_modules);
+    }
+}
+
+SpirVOutputCapture::SpirVOutputCapture()
+{
+#ifdef SPIRV_BATCH_USE_MEMSTREAM
+    file_ = open_memstream(&buffer_, &size_);
+#else
+    file_ = tmpfile();
+#endif
+}
+
+SpirVOutputCapture::~SpirVOutputCapture()
+{
+    Finish();
+}
+
+std::string SpirVOutputCapture::Finish()
+{
+    std::string output;
+    if (!file_)
+    {
+        return output;
+    }
+
+#ifdef SPIRV_BATCH_USE_MEMSTREAM
+    // the buffer is only guaranteed to be up to date once the stream is flushed or closed
+    fclose(file_);
+    if (buffer_)
+    {
+        output.assign(buffer_, size_);
+        free(buffer_);
+    }
+    buffer_ = nullptr;
+    size_   = 0;
+#else
+    const long size = ftell(file_);
+    if (size > 0)
+    {
+        output.resize(static_cast<size_t>(size));
+        rewind(file_);
+        output.resize(fread(output.data(), 1, output.size(), file_));
+    }
+    fclose(file_);
+#endif
+    file_ = nullptr;
+    return output;
+}
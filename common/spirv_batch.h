@@ -0,0 +1,96 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_BATCH_H
+#define SPIRV_PARSING_COMMON_SPIRV_BATCH_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// SpirVBatch turns command line inputs into the list of SPIR-V modules to analyze in one process and keeps the
+// aggregate numbers for the throughput report.
+//
+// Inputs can be:
+//  - a file, analyzed as is
+//  - a directory, every *.spv file below it is added (sorted, so runs are reproducible)
+//  - a manifest, one path per line, empty lines and lines starting with '#' are skipped,
+//    relative paths are relative to the manifest's directory
+class SpirVBatch
+{
+  public:
+    struct Stats
+    {
+        size_t num_modules = 0;
+        size_t num_failed  = 0;
+        size_t num_cached  = 0;
+        size_t num_bytes   = 0;
+        double duration_ms = 0.0;
+    };
+
+    //! add a file or every *.spv file below a directory, returns false if 'path' doesn't exist
+    bool AddInput(const std::string& path);
+
+    //! add every path listed in the manifest file, returns false if it can't be read
+    bool AddManifest(const std::string& manifest_path);
+
+    //! true once a directory or manifest was added, or more than one file
+    [[nodiscard]] bool is_batch() const { return is_batch_ || files_.size() > 1; }
+
+    [[nodiscard]] const std::vector<std::string>& files() const { return files_; }
+
+    //! indices into files(), largest file first, for scheduling the modules on several workers
+    [[nodiscard]] std::vector<size_t> LargestFirstOrder() const;
+
+    //! print module count, size, time and throughput in MB/s and modules/s
+    static void PrintStats(const Stats& stats, FILE* out = stdout);
+
+  private:
+    std::vector<std::string> files_{};
+    bool                     is_batch_ = false;
+};
+
+// SpirVOutputCapture collects everything written to file() in memory, so a worker can report on its module while
+// other workers are running and the batch still prints the reports in input order.
+class SpirVOutputCapture
+{
+  public:
+    SpirVOutputCapture();
+    ~SpirVOutputCapture();
+
+    SpirVOutputCapture(const SpirVOutputCapture&)            = delete;
+    SpirVOutputCapture& operator=(const SpirVOutputCapture&) = delete;
+
+    //! stream to write to, falls back to stdout if no in-memory stream could be created
+    [[nodiscard]] FILE* file() const { return file_ ? file_ : stdout; }
+
+    //! close the stream and return everything written to it
+    std::string Finish();
+
+  private:
+    FILE*  file_   = nullptr;
+    char*  buffer_ = nullptr;
+    size_t size_   = 0;
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_BATCH_H
@@ -0,0 +1,243 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_batch_runner.h"
+#include "spirv_file.h"
+#include "spirv_ndjson_writer.h"
+#include "spirv_result_cache.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+SpirVBatchRunner::SpirVBatchRunner(const SpirVBatch& batch, const Options& options)
+    : batch_(batch), options_(options), thread_pool_(batch.is_batch() ? options.num_jobs : 1)
+{
+}
+
+bool SpirVBatchRunner::Analyze(const ReportFunction& report,
+                               size_t                worker_index,
+                               SpirVNdjsonWriter&    writer,
+                               const std::string&    path,
+                               const SpirVFile&      spirv,
+                               FILE*                 output,
+                               bool&                 cached) const
+{
+    // NDJSON records are tagged with the file after the cache, so stored records don't depend on where the module
+    // was found
+    cached = false;
+    if (!options_.cache)
+    {
+        writer.SetOutput(output);
+        writer.SetRecordField("file", path.c_str());
+        const bool success = report(worker_index, writer, spirv, output);
+        writer.Flush();
+        return success;
+    }
+
+    const SpirVResultCache::Key key = SpirVResultCache::KeyOf(spirv.data(), spirv.size_bytes());
+    SpirVResultCache::Entry     entry;
+    cached = options_.cache->Load(key, entry);
+    if (!cached)
+    {
+        SpirVOutputCapture capture;
+        writer.SetOutput(capture.file());
+        writer.SetRecordField(nullptr, nullptr);
+        entry.failed = !report(worker_index, writer, spirv, capture.file());
+        writer.Flush();
+        entry.payload = capture.Finish();
+        options_.cache->Store(key, entry);
+    }
+
+    if (options_.ndjson)
+    {
+        writer.SetOutput(output);
+        writer.SetRecordField("file", path.c_str());
+        writer.AppendRecords(entry.payload.data(), entry.payload.size());
+        writer.Flush();
+    }
+    else
+    {
+        fwrite(entry.payload.data(), 1, entry.payload.size(), output);
+    }
+    return !entry.failed;
+}
+
+int SpirVBatchRunner::Run(const ReportFunction& report) const
+{
+    return batch_.is_batch() ? RunBatch(report) : RunSingle(report);
+}
+
+int SpirVBatchRunner::RunSingle(const ReportFunction& report) const
+{
+    const std::string& path = batch_.files()[0];
+    SpirVFile          spirv;
+    if (!spirv.Open(path.c_str()) || spirv.num_words() < options_.min_num_words)
+    {
+        printf("ERROR: Unable to open the input file %s\n", path.c_str());
+        return EXIT_FAILURE;
+    }
+
+    const auto start_time = std::chrono::high_resolution_clock::now();
+
+    SpirVNdjsonWriter writer;
+    bool              cached  = false;
+    const bool        success = Analyze(report, 0, writer, path, spirv, options_.output, cached);
+
+    const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start_time;
+    fflush(options_.output);
+    fprintf(options_.ndjson ? stderr : stdout, "Time = %g ms\n", duration.count());
+    return success ? 0 : EXIT_FAILURE;
+}
+
+int SpirVBatchRunner::RunBatch(const ReportFunction& report) const
+{
+    // a loader and a writer per worker, reused for every module the worker picks up
+    std::vector<SpirVFile>                          spirv_files(num_workers());
+    std::vector<std::unique_ptr<SpirVNdjsonWriter>> writers(num_workers());
+    for (auto& writer : writers)
+    {
+        writer = std::make_unique<SpirVNdjsonWriter>();
+    }
+
+    // written by whichever worker ran the module. A report is printed as soon as it and every module before it in
+    // input order are done, and freed right after, so only the modules finished out of order are held in memory
+    struct ModuleResult
+    {
+        std::string output;
+        size_t      num_bytes = 0;
+        bool        failed    = false;
+        bool        cached    = false;
+        bool        done      = false;
+    };
+    std::vector<ModuleResult> results(batch_.files().size());
+
+    // guards the done flags, the cursor and the stats
+    std::mutex        commit_mutex;
+    size_t            next_to_commit = 0;
+    SpirVBatch::Stats stats;
+
+    const auto start_time = std::chrono::high_resolution_clock::now();
+
+    thread_pool_.Run(batch_.LargestFirstOrder(), [&](size_t worker_index, size_t file_index) {
+        const std::string& path   = batch_.files()[file_index];
+        ModuleResult&      result = results[file_index];
+        SpirVNdjsonWriter& writer = *writers[worker_index];
+
+        std::optional<SpirVOutputCapture> capture(std::in_place);
+        auto start_report = [&]() {
+            if (!options_.ndjson)
+            {
+                fprintf(capture->file(), "== %s ==\n", path.c_str());
+            }
+        };
+        // the module counts as failed, 'message' is followed by the path in the text report
+        auto report_error = [&](const char* message, const char* detail) {
+            if (options_.ndjson)
+            {
+                writer.SetOutput(capture->file());
+                writer.SetRecordField("file", path.c_str());
+                writer.BeginObject();
+                writer.String("type", "error");
+                writer.String("message", message);
+                if (detail)
+                {
+                    writer.String("detail", detail);
+                }
+                writer.EndObject();
+                writer.Flush();
+            }
+            else
+            {
+                fprintf(capture->file(), "ERROR: %s %s%s%s\n", message, path.c_str(), detail ? ": " : "",
+                        detail ? detail : "");
+            }
+            result.failed = true;
+        };
+        start_report();
+
+        SpirVFile& spirv = spirv_files[worker_index];
+        if (!spirv.Open(path.c_str()) || spirv.num_words() < options_.min_num_words)
+        {
+            report_error("Unable to open the input file", nullptr);
+        }
+        else
+        {
+            result.num_bytes = spirv.size_bytes();
+
+            // a module that makes its pass throw is reported like any other failure instead of ending the batch
+            std::string exception_message;
+            try
+            {
+                result.failed = !Analyze(report, worker_index, writer, path, spirv, capture->file(), result.cached);
+            }
+            catch (const std::exception& exception)
+            {
+                exception_message = exception.what();
+            }
+            catch (...)
+            {
+                exception_message = "unknown exception";
+            }
+            if (!exception_message.empty())
+            {
+                // the report may have stopped in the middle of a record, what it wrote so far is dropped
+                writer.Reset();
+                capture->Finish();
+                capture.emplace();
+                start_report();
+                report_error("Exception while analyzing", exception_message.c_str());
+            }
+        }
+        result.output = capture->Finish();
+
+        std::lock_guard<std::mutex> lock(commit_mutex);
+        result.done = true;
+        if (next_to_commit != file_index)
+        {
+            return;
+        }
+        while (next_to_commit < results.size() && results[next_to_commit].done)
+        {
+            ModuleResult& ready = results[next_to_commit++];
+            fwrite(ready.output.data(), 1, ready.output.size(), options_.output);
+            std::string().swap(ready.output);
+
+            stats.num_modules++;
+            stats.num_failed += ready.failed ? 1 : 0;
+            stats.num_cached += ready.cached ? 1 : 0;
+            stats.num_bytes += ready.num_bytes;
+        }
+        // whoever reads the output gets the reports now rather than when the batch is done
+        fflush(options_.output);
+    });
+
+    const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start_time;
+    stats.duration_ms = duration.count();
+    SpirVBatch::PrintStats(stats, options_.ndjson ? stderr : stdout);
+
+    return stats.num_failed == 0 ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,96 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_BATCH_RUNNER_H
+#define SPIRV_PARSING_COMMON_SPIRV_BATCH_RUNNER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include "spirv_batch.h"
+#include "spirv_thread_pool.h"
+
+class SpirVFile;
+class SpirVNdjsonWriter;
+class SpirVResultCache;
+
+// SpirVBatchRunner is the driver the tools share. It analyzes one module or a whole batch on the thread pool, answers
+// modules from the result cache where it can and writes the reports, as text or as NDJSON records tagged with their
+// file, in input order.
+//
+// A tool keeps one analyzer per worker (see num_workers()) and only supplies how a single module is reported.
+class SpirVBatchRunner
+{
+  public:
+    struct Options
+    {
+        //! workers of a batch, 0 uses every hardware thread
+        size_t num_jobs = 0;
+
+        //! one NDJSON record per result instead of the text report, the time and summary go to stderr
+        bool ndjson = false;
+
+        //! files with fewer words are reported as unopenable
+        size_t min_num_words = 0;
+
+        //! answer modules from here and store the others, nullptr analyzes every module
+        SpirVResultCache* cache = nullptr;
+
+        //! where the reports go, e.g. a file opened by the tool
+        FILE* output = stdout;
+    };
+
+    //! analyze the module and write its report to 'output', as text or (with Options::ndjson) as records through
+    //! 'writer', which is already set up for 'output'. Returns false if the analysis failed
+    using ReportFunction =
+        std::function<bool(size_t worker_index, SpirVNdjsonWriter& writer, const SpirVFile& spirv, FILE* output)>;
+
+    SpirVBatchRunner(const SpirVBatch& batch, const Options& options);
+
+    //! number of workers Run() reports from, worker indices are below it
+    [[nodiscard]] size_t num_workers() const { return thread_pool_.num_workers(); }
+
+    //! report every module, then print the time of a single module or the summary of a batch.
+    //! Returns the exit code of the tool
+    int Run(const ReportFunction& report) const;
+
+  private:
+    // report one module, a cache hit skips the analysis and writes the stored report
+    bool Analyze(const ReportFunction& report,
+                 size_t                worker_index,
+                 SpirVNdjsonWriter&    writer,
+                 const std::string&    path,
+                 const SpirVFile&      spirv,
+                 FILE*                 output,
+                 bool&                 cached) const;
+
+    int RunSingle(const ReportFunction& report) const;
+    int RunBatch(const ReportFunction& report) const;
+
+    const SpirVBatch& batch_;
+    Options           options_{};
+    SpirVThreadPool   thread_pool_;
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_BATCH_RUNNER_H
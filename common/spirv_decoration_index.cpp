@@ -0,0 +1,141 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_decoration_index.h"
+#include "spirv.hpp"
+
+void SpirVDecorationIndex::Reset(uint32_t id_bound)
+{
+    id_slots_.assign(id_bound, 0);
+    member_slots_.Clear();
+    records_.clear();
+}
+
+void SpirVDecorationIndex::ShrinkToFit()
+{
+    id_slots_.shrink_to_fit();
+    member_slots_.ShrinkToFit();
+    records_.shrink_to_fit();
+}
+
+size_t SpirVDecorationIndex::used_bytes() const
+{
+    return id_slots_.size() * sizeof(uint32_t) + member_slots_.used_bytes() + records_.size() * sizeof(Decorations);
+}
+
+size_t SpirVDecorationIndex::retained_bytes() const
+{
+    return id_slots_.capacity() * sizeof(uint32_t) + member_slots_.retained_bytes() +
+           records_.capacity() * sizeof(Decorations);
+}
+
+bool SpirVDecorationIndex::Apply(Decorations& decorations, uint32_t decoration, uint32_t value)
+{
+    switch (decoration)
+    {
+        case spv::DecorationDescriptorSet:
+            decorations.flags |= Decorations::DESCRIPTOR_SET;
+            decorations.descriptor_set = value;
+            return true;
+        case spv::DecorationBinding:
+            decorations.flags |= Decorations::BINDING;
+            decorations.binding = value;
+            return true;
+        case spv::DecorationLocation:
+            decorations.flags |= Decorations::LOCATION;
+            decorations.location = value;
+            return true;
+        case spv::DecorationBuiltIn:
+            decorations.flags |= Decorations::BUILT_IN;
+            decorations.built_in = value;
+            return true;
+        case spv::DecorationOffset:
+            decorations.flags |= Decorations::OFFSET;
+            decorations.offset = value;
+            return true;
+        case spv::DecorationArrayStride:
+            decorations.flags |= Decorations::ARRAY_STRIDE;
+            decorations.array_stride = value;
+            return true;
+        case spv::DecorationBlock:
+            decorations.flags |= Decorations::BLOCK;
+            return true;
+        case spv::DecorationBufferBlock:
+            decorations.flags |= Decorations::BUFFER_BLOCK;
+            return true;
+        default:
+            return false;
+    }
+}
+
+void SpirVDecorationIndex::AddDecoration(uint32_t target_id, uint32_t decoration, uint32_t value)
+{
+    if (target_id >= id_slots_.size())
+    {
+        return;
+    }
+
+    uint32_t& slot = id_slots_[target_id];
+    if (slot != 0)
+    {
+        Apply(records_[slot - 1], decoration, value);
+        return;
+    }
+
+    Decorations decorations;
+    if (Apply(decorations, decoration, value))
+    {
+        records_.push_back(decorations);
+        slot = static_cast<uint32_t>(records_.size());
+    }
+}
+
+void SpirVDecorationIndex::AddMemberDecoration(uint32_t struct_id, uint32_t member, uint32_t decoration, uint32_t value)
+{
+    if (const uint32_t* slot = member_slots_.Find(struct_id, member))
+    {
+        Apply(records_[*slot - 1], decoration, value);
+        return;
+    }
+
+    Decorations decorations;
+    if (Apply(decorations, decoration, value))
+    {
+        records_.push_back(decorations);
+        member_slots_(struct_id, member) = static_cast<uint32_t>(records_.size());
+    }
+}
+
+const SpirVDecorationIndex::Decorations* SpirVDecorationIndex::Find(uint32_t id) const
+{
+    if (id >= id_slots_.size() || id_slots_[id] == 0)
+    {
+        return nullptr;
+    }
+    return &records_[id_slots_[id] - 1];
+}
+
+const SpirVDecorationIndex::Decorations* SpirVDecorationIndex::FindMember(uint32_t struct_id, uint32_t member) const
+{
+    const uint32_t* slot = member_slots_.Find(struct_id, member);
+    return slot ? &records_[*slot - 1] : nullptr;
+}
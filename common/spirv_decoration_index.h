@@ -0,0 +1,100 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_DECORATION_INDEX_H
+#define SPIRV_PARSING_COMMON_SPIRV_DECORATION_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "spirv_member_map.h"
+
+// SpirVDecorationIndex collects the decorations the passes care about, per target ID and per struct member.
+//
+// It is filled once while walking the OpDecorate/OpMemberDecorate instructions and afterwards answers
+// queries in constant time, instead of every query walking all decoration instructions again.
+class SpirVDecorationIndex
+{
+  public:
+    struct Decorations
+    {
+        enum Flags : uint32_t
+        {
+            DESCRIPTOR_SET = 1u << 0,
+            BINDING        = 1u << 1,
+            LOCATION       = 1u << 2,
+            BUILT_IN       = 1u << 3,
+            OFFSET         = 1u << 4,
+            ARRAY_STRIDE   = 1u << 5,
+            BLOCK          = 1u << 6,
+            BUFFER_BLOCK   = 1u << 7
+        };
+
+        //! which of the values below were decorated
+        uint32_t flags = 0;
+
+        uint32_t descriptor_set = 0;
+        uint32_t binding        = 0;
+        uint32_t location       = 0;
+        uint32_t built_in       = 0;
+        uint32_t offset         = 0;
+        uint32_t array_stride   = 0;
+
+        [[nodiscard]] bool has(uint32_t flag) const { return (flags & flag) != 0; }
+    };
+
+    //! drop all decorations and size the per-ID table for 'id_bound' IDs, keeps allocated memory
+    void Reset(uint32_t id_bound);
+
+    //! record an OpDecorate, 'value' is the first literal operand (or 0 if there is none)
+    void AddDecoration(uint32_t target_id, uint32_t decoration, uint32_t value);
+
+    //! record an OpMemberDecorate, 'value' is the first literal operand (or 0 if there is none)
+    void AddMemberDecoration(uint32_t struct_id, uint32_t member, uint32_t decoration, uint32_t value);
+
+    //! decorations of an ID, nullptr if none of the tracked decorations were applied to it
+    [[nodiscard]] const Decorations* Find(uint32_t id) const;
+
+    //! decorations of a struct member, nullptr if none of the tracked decorations were applied to it
+    [[nodiscard]] const Decorations* FindMember(uint32_t struct_id, uint32_t member) const;
+
+    //! release the capacity past what the current module needs
+    void ShrinkToFit();
+
+    //! bytes the current module needs, and bytes held for the next Reset()
+    [[nodiscard]] size_t used_bytes() const;
+    [[nodiscard]] size_t retained_bytes() const;
+
+  private:
+    static bool Apply(Decorations& decorations, uint32_t decoration, uint32_t value);
+
+    // per-ID index into records_, offset by one so 0 means "not decorated"
+    std::vector<uint32_t> id_slots_{};
+
+    // (struct ID, member) -> index into records_, offset by one as well
+    SpirVMemberMap<uint32_t> member_slots_{};
+
+    std::vector<Decorations> records_{};
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_DECORATION_INDEX_H
@@ -0,0 +1,183 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_diagnostics.h"
+#include "spirv_ndjson_writer.h"
+#include "helper.h"
+
+#include <cstring>
+
+SpirVDiagnosticSeverity SpirVDiagnostics::SeverityOf(SpirVDiagnosticCode code)
+{
+    switch (code)
+    {
+        case SpirVDiagnosticCode::STORAGE_CLASS_NOT_HANDLED:
+            return SpirVDiagnosticSeverity::INFO;
+
+        case SpirVDiagnosticCode::ACCESS_CHAIN_OUT_OF_BOUNDS:
+        case SpirVDiagnosticCode::TYPE_MISMATCH:
+        case SpirVDiagnosticCode::UNTRACEABLE_STORE:
+            return SpirVDiagnosticSeverity::WARNING;
+
+        case SpirVDiagnosticCode::MODULE_TOO_SMALL:
+        case SpirVDiagnosticCode::INVALID_INSTRUCTION_LENGTH:
+        case SpirVDiagnosticCode::INVALID_ID_BOUND:
+        case SpirVDiagnosticCode::REFLECT_FAILED:
+        case SpirVDiagnosticCode::UNMAPPABLE_MODULE:
+            break;
+    }
+    return SpirVDiagnosticSeverity::ERROR;
+}
+
+const char* SpirVDiagnostics::SeverityName(SpirVDiagnosticSeverity severity)
+{
+    switch (severity)
+    {
+        case SpirVDiagnosticSeverity::INFO:
+            return "info";
+        case SpirVDiagnosticSeverity::WARNING:
+            return "warning";
+        case SpirVDiagnosticSeverity::ERROR:
+            break;
+    }
+    return "error";
+}
+
+bool SpirVDiagnostics::ParseSeverity(const char* name, SpirVDiagnosticSeverity& severity)
+{
+    for (SpirVDiagnosticSeverity candidate :
+         {SpirVDiagnosticSeverity::INFO, SpirVDiagnosticSeverity::WARNING, SpirVDiagnosticSeverity::ERROR})
+    {
+        if (strcmp(name, SeverityName(candidate)) == 0)
+        {
+            severity = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* SpirVDiagnostics::CodeName(SpirVDiagnosticCode code)
+{
+    switch (code)
+    {
+        case SpirVDiagnosticCode::STORAGE_CLASS_NOT_HANDLED:
+            return "storage-class-not-handled";
+        case SpirVDiagnosticCode::ACCESS_CHAIN_OUT_OF_BOUNDS:
+            return "access-chain-out-of-bounds";
+        case SpirVDiagnosticCode::TYPE_MISMATCH:
+            return "type-mismatch";
+        case SpirVDiagnosticCode::UNTRACEABLE_STORE:
+            return "untraceable-store";
+        case SpirVDiagnosticCode::MODULE_TOO_SMALL:
+            return "module-too-small";
+        case SpirVDiagnosticCode::INVALID_INSTRUCTION_LENGTH:
+            return "invalid-instruction-length";
+        case SpirVDiagnosticCode::INVALID_ID_BOUND:
+            return "invalid-id-bound";
+        case SpirVDiagnosticCode::REFLECT_FAILED:
+            return "reflect-failed";
+        case SpirVDiagnosticCode::UNMAPPABLE_MODULE:
+            break;
+    }
+    return "unmappable-module";
+}
+
+void SpirVDiagnostics::FormatMessage(const SpirVDiagnostic& diagnostic, char* buffer, size_t size)
+{
+    // the messages printed before diagnostics were collected, so the text report reads the same
+    switch (diagnostic.code)
+    {
+        case SpirVDiagnosticCode::STORAGE_CLASS_NOT_HANDLED:
+            snprintf(buffer, size, "Storage class %u not handled", diagnostic.value);
+            break;
+        case SpirVDiagnosticCode::ACCESS_CHAIN_OUT_OF_BOUNDS:
+            snprintf(buffer, size, "Access-chain index is out-of-bounds for op: %s", string_SpvOpcode(diagnostic.opcode));
+            break;
+        case SpirVDiagnosticCode::TYPE_MISMATCH:
+            snprintf(buffer,
+                     size,
+                     "Traced back a potential buffer-reference, but type does not match: %s",
+                     string_SpvOpcode(diagnostic.opcode));
+            break;
+        case SpirVDiagnosticCode::UNTRACEABLE_STORE:
+            snprintf(buffer,
+                     size,
+                     "Failed to track back the Function Variable OpStore, hit a %s",
+                     string_SpvOpcode(diagnostic.opcode));
+            break;
+        case SpirVDiagnosticCode::MODULE_TOO_SMALL:
+            snprintf(buffer, size, "SpirV-module is too small to hold a header");
+            break;
+        case SpirVDiagnosticCode::INVALID_INSTRUCTION_LENGTH:
+            snprintf(buffer, size, "error during SpirV-parsing, mismatching instruction-lengths");
+            break;
+        case SpirVDiagnosticCode::INVALID_ID_BOUND:
+            snprintf(buffer, size, "SpirV-module has an invalid ID bound %u", diagnostic.value);
+            break;
+        case SpirVDiagnosticCode::REFLECT_FAILED:
+            snprintf(buffer, size, "spirv-reflect failed to parse the SpirV-module");
+            break;
+        case SpirVDiagnosticCode::UNMAPPABLE_MODULE:
+            snprintf(buffer, size, "Unable to map the SpirV-module");
+            break;
+    }
+}
+
+void SpirVDiagnostics::Print(FILE* output) const
+{
+    char message[256];
+    for (const SpirVDiagnostic& diagnostic : diagnostics_)
+    {
+        FormatMessage(diagnostic, message, sizeof(message));
+
+        // errors keep the "warning: " of the old messages, the run goes on with the next module
+        fprintf(output,
+                "%s%s\n",
+                diagnostic.severity == SpirVDiagnosticSeverity::INFO ? "" : "warning: ",
+                message);
+    }
+}
+
+void SpirVDiagnostics::Emit(SpirVNdjsonWriter& writer) const
+{
+    char message[256];
+    for (const SpirVDiagnostic& diagnostic : diagnostics_)
+    {
+        FormatMessage(diagnostic, message, sizeof(message));
+
+        writer.BeginObject();
+        writer.String("type", "diagnostic");
+        writer.String("severity", SeverityName(diagnostic.severity));
+        writer.String("code", CodeName(diagnostic.code));
+        if (diagnostic.opcode != SpirVDiagnostic::kNone)
+        {
+            writer.String("opcode", string_SpvOpcode(diagnostic.opcode));
+        }
+        if (diagnostic.word_offset != SpirVDiagnostic::kNone)
+        {
+            writer.UInt("word_offset", diagnostic.word_offset);
+        }
+        writer.String("message", message);
+        writer.EndObject();
+    }
+}
@@ -0,0 +1,129 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_DIAGNOSTICS_H
+#define SPIRV_PARSING_COMMON_SPIRV_DIAGNOSTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+class SpirVNdjsonWriter;
+
+enum class SpirVDiagnosticSeverity : uint8_t
+{
+    //! something the pass skipped on purpose, e.g. a storage class that can't hold buffer-references
+    INFO = 0,
+
+    //! part of the module could not be followed, the results may be incomplete
+    WARNING,
+
+    //! the module could not be analyzed at all
+    ERROR
+};
+
+enum class SpirVDiagnosticCode : uint16_t
+{
+    //! 'value' is the storage class
+    STORAGE_CLASS_NOT_HANDLED = 0,
+
+    ACCESS_CHAIN_OUT_OF_BOUNDS,
+    TYPE_MISMATCH,
+    UNTRACEABLE_STORE,
+    MODULE_TOO_SMALL,
+    INVALID_INSTRUCTION_LENGTH,
+
+    //! 'value' is the ID bound of the header
+    INVALID_ID_BOUND,
+
+    REFLECT_FAILED,
+    UNMAPPABLE_MODULE
+};
+
+// one diagnostic, only the raw values are kept and the message is formatted when it is printed
+struct SpirVDiagnostic
+{
+    //! for the opcode and word offset of diagnostics that aren't about an instruction
+    static constexpr uint32_t kNone = 0xFFFFFFFF;
+
+    SpirVDiagnosticCode     code        = SpirVDiagnosticCode::STORAGE_CLASS_NOT_HANDLED;
+    SpirVDiagnosticSeverity severity    = SpirVDiagnosticSeverity::INFO;
+    uint32_t                opcode      = kNone;
+    uint32_t                word_offset = kNone;
+    uint32_t                value       = 0;
+};
+
+// SpirVDiagnostics collects the diagnostics of one analysis, to be printed once it is done.
+//
+// Reporting appends a small record and never formats or writes anything, so a pass running on many threads doesn't
+// serialize on a FILE lock. Every analyzer owns its buffer and is only used by one thread at a time, so there is
+// nothing to lock. Diagnostics below the minimum severity are dropped when reported; clearing keeps the memory.
+class SpirVDiagnostics
+{
+  public:
+    //! diagnostics below 'severity' are dropped, by default all are kept
+    void SetMinimumSeverity(SpirVDiagnosticSeverity severity) { minimum_severity_ = severity; }
+
+    [[nodiscard]] SpirVDiagnosticSeverity minimum_severity() const { return minimum_severity_; }
+
+    void Report(SpirVDiagnosticCode code,
+                uint32_t            opcode      = SpirVDiagnostic::kNone,
+                uint32_t            word_offset = SpirVDiagnostic::kNone,
+                uint32_t            value       = 0)
+    {
+        const SpirVDiagnosticSeverity severity = SeverityOf(code);
+        if (severity >= minimum_severity_)
+        {
+            diagnostics_.push_back({code, severity, opcode, word_offset, value});
+        }
+    }
+
+    void Clear() { diagnostics_.clear(); }
+
+    [[nodiscard]] const std::vector<SpirVDiagnostic>& entries() const { return diagnostics_; }
+    [[nodiscard]] bool                                empty() const { return diagnostics_.empty(); }
+
+    //! one line per diagnostic, warnings and errors are prefixed with "warning: "
+    void Print(FILE* output) const;
+
+    //! one NDJSON record per diagnostic
+    void Emit(SpirVNdjsonWriter& writer) const;
+
+    static SpirVDiagnosticSeverity SeverityOf(SpirVDiagnosticCode code);
+
+    //! "info", "warning" and "error", as used on the command-line and in the NDJSON records
+    static const char* SeverityName(SpirVDiagnosticSeverity severity);
+    static bool        ParseSeverity(const char* name, SpirVDiagnosticSeverity& severity);
+
+    //! e.g. "access-chain-out-of-bounds"
+    static const char* CodeName(SpirVDiagnosticCode code);
+
+    //! the message of 'diagnostic' without the severity prefix, truncated to fit 'size'
+    static void FormatMessage(const SpirVDiagnostic& diagnostic, char* buffer, size_t size);
+
+  private:
+    SpirVDiagnosticSeverity      minimum_severity_ = SpirVDiagnosticSeverity::INFO;
+    std::vector<SpirVDiagnostic> diagnostics_{};
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_DIAGNOSTICS_H
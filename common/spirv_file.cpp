@@ -0,0 +1,192 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_file.h"
+
+#include <cstdio>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SPIRV_FILE_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+// a descriptor whose size and contents can't change any more, the only kind that is safe to map from another process
+static bool IsSealed(int fd)
+{
+    const int required = F_SEAL_SHRINK | F_SEAL_WRITE;
+    const int seals    = fcntl(fd, F_GET_SEALS);
+    return seals >= 0 && (seals & required) == required;
+}
+#else
+static bool IsSealed(int fd)
+{
+    (void)fd;
+    return false;
+}
+#endif
+
+SpirVFile::~SpirVFile()
+{
+    Close();
+}
+
+SpirVFile::SpirVFile(SpirVFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+SpirVFile& SpirVFile::operator=(SpirVFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        words_        = std::exchange(other.words_, nullptr);
+        num_words_    = std::exchange(other.num_words_, 0);
+        mapping_      = std::exchange(other.mapping_, nullptr);
+        mapping_size_ = std::exchange(other.mapping_size_, 0);
+        buffer_       = std::move(other.buffer_);
+        other.buffer_.clear();
+    }
+    return *this;
+}
+
+bool SpirVFile::Open(const char* path)
+{
+    Close();
+    if (path == nullptr)
+    {
+        return false;
+    }
+    return Map(path) || Read(path);
+}
+
+void SpirVFile::Close()
+{
+#ifdef SPIRV_FILE_USE_MMAP
+    if (mapping_ != nullptr)
+    {
+        munmap(mapping_, mapping_size_);
+    }
+#endif
+    mapping_      = nullptr;
+    mapping_size_ = 0;
+    words_        = nullptr;
+    num_words_    = 0;
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+}
+
+bool SpirVFile::OpenDescriptor(int fd)
+{
+    Close();
+    return fd >= 0 && IsSealed(fd) && MapDescriptor(fd);
+}
+
+bool SpirVFile::Map(const char* path)
+{
+#ifdef SPIRV_FILE_USE_MMAP
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // the mapping keeps its own reference to the file
+    const bool mapped = MapDescriptor(fd);
+    close(fd);
+    return mapped;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool SpirVFile::MapDescriptor(int fd)
+{
+#ifdef SPIRV_FILE_USE_MMAP
+    struct stat file_stat = {};
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0)
+    {
+        // empty files can't be mapped, let the read path deal with them
+        return false;
+    }
+
+    const size_t file_size = static_cast<size_t>(file_stat.st_size);
+    void*        mapping   = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    // the whole module is about to be walked, start paging it in now
+    madvise(mapping, file_size, MADV_WILLNEED);
+
+    mapping_      = mapping;
+    mapping_size_ = file_size;
+    words_        = static_cast<const uint32_t*>(mapping);
+    num_words_    = file_size / sizeof(uint32_t);
+    return true;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+bool SpirVFile::Read(const char* path)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+    {
+        return false;
+    }
+
+    long file_size = -1;
+    if (fseek(fp, 0, SEEK_END) == 0)
+    {
+        file_size = ftell(fp);
+    }
+    if (file_size < 0 || fseek(fp, 0, SEEK_SET) != 0)
+    {
+        fclose(fp);
+        return false;
+    }
+
+    // one allocation and one read for the whole module
+    buffer_.resize(static_cast<size_t>(file_size) / sizeof(uint32_t));
+    const size_t num_read = fread(buffer_.data(), sizeof(uint32_t), buffer_.size(), fp);
+    fclose(fp);
+
+    if (num_read != buffer_.size())
+    {
+        buffer_.clear();
+        return false;
+    }
+
+    words_     = buffer_.empty() ? nullptr : buffer_.data();
+    num_words_ = buffer_.size();
+    return true;
+}
@@ -0,0 +1,87 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_FILE_H
+#define SPIRV_PARSING_COMMON_SPIRV_FILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// SpirVFile gives read-only access to the words of a SPIR-V binary on disk.
+//
+// The file is memory-mapped when the platform supports it, so the words can be handed straight to the parsers
+// without being copied. Otherwise (or if mapping fails) the whole file is read with a single pre-sized read.
+class SpirVFile
+{
+  public:
+    SpirVFile() = default;
+    ~SpirVFile();
+
+    SpirVFile(const SpirVFile&)            = delete;
+    SpirVFile& operator=(const SpirVFile&) = delete;
+
+    SpirVFile(SpirVFile&& other) noexcept;
+    SpirVFile& operator=(SpirVFile&& other) noexcept;
+
+    //! map or read the file at 'path', returns false if it could not be opened or read
+    bool Open(const char* path);
+
+    //! map an open file descriptor read-only, e.g. a memfd handed over by another process. The descriptor has to be
+    //! sealed with F_SEAL_SHRINK and F_SEAL_WRITE, otherwise its owner could truncate it (SIGBUS on the next read) or
+    //! rewrite instructions after they were validated. Unsealed descriptors are rejected, as is every descriptor where
+    //! sealing is unsupported (shm_open segments, regular files), so only sealed memfds are accepted. The descriptor
+    //! stays owned by the caller and can be closed right away
+    bool OpenDescriptor(int fd);
+
+    //! release the mapping or buffer, safe to call on a closed file
+    void Close();
+
+    //! first word of the binary, nullptr when nothing is loaded
+    [[nodiscard]] const uint32_t* data() const { return words_; }
+
+    //! size of the binary in bytes, trailing bytes that don't form a full word are ignored
+    [[nodiscard]] size_t size_bytes() const { return num_words_ * sizeof(uint32_t); }
+
+    //! size of the binary in words
+    [[nodiscard]] size_t num_words() const { return num_words_; }
+
+    //! true if the words point into a file mapping rather than a heap buffer
+    [[nodiscard]] bool is_mapped() const { return mapping_ != nullptr; }
+
+  private:
+    bool Map(const char* path);
+    bool MapDescriptor(int fd);
+    bool Read(const char* path);
+
+    const uint32_t* words_     = nullptr;
+    size_t          num_words_ = 0;
+
+    // set when the file is memory-mapped
+    void*  mapping_      = nullptr;
+    size_t mapping_size_ = 0;
+
+    // fallback storage when the file could not be mapped
+    std::vector<uint32_t> buffer_{};
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_FILE_H
@@ -0,0 +1,124 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_instruction.h"
+
+#include "spirv_opcode_table.h"
+
+SpirVInstructionTable::Status SpirVInstructionTable::Build(const uint32_t* spirv_code,
+                                                          size_t          spirv_num_bytes,
+                                                          size_t          num_instructions_hint)
+{
+    Clear();
+
+    const size_t num_words = spirv_num_bytes / sizeof(uint32_t);
+    if (spirv_code == nullptr || num_words < kHeaderSize)
+    {
+        return Status::TOO_SMALL;
+    }
+
+    const uint32_t id_bound = spirv_code[kIdBoundWordIndex];
+    if (id_bound > kMaxIdBound)
+    {
+        return Status::INVALID_ID_BOUND;
+    }
+
+    // without a hint, a rough guess for the number of instructions, most are 3-5 words
+    const size_t expected_size = num_instructions_hint != 0 ? num_instructions_hint : num_words / 4;
+    word_offsets_.reserve(expected_size);
+    opcodes_.reserve(expected_size);
+    result_ids_.reserve(expected_size);
+    type_ids_.reserve(expected_size);
+    definitions_.assign(id_bound, kNoDefinition);
+
+    size_t offset = kHeaderSize;
+    while (offset < num_words)
+    {
+        const uint32_t first_word = spirv_code[offset];
+        const uint32_t length     = first_word >> 16;
+        const uint32_t opcode     = first_word & 0x0ffffu;
+        if (length == 0 || length > num_words - offset)
+        {
+            Clear();
+            return Status::INVALID_INSTRUCTION_LENGTH;
+        }
+
+        // branch-free decode: a word that isn't there is read as the first word and masked off,
+        // so nothing past the instruction is touched
+        const uint32_t properties   = SpirVOpcodeTable::GetProperties(opcode);
+        const uint32_t has_type     = properties & SpirVOpcodeTable::HAS_TYPE;
+        const uint32_t has_result   = (properties & SpirVOpcodeTable::HAS_RESULT) >> 1;
+        const uint32_t result_index = 1 + has_type;
+        const uint32_t type_mask    = 0u - (has_type & static_cast<uint32_t>(length > 1));
+        const uint32_t result_mask  = 0u - (has_result & static_cast<uint32_t>(length > result_index));
+        const uint32_t type_id      = spirv_code[offset + (type_mask & 1u)] & type_mask;
+        const uint32_t result_id    = spirv_code[offset + (result_mask & result_index)] & result_mask;
+
+        if (result_id != 0 && result_id < id_bound && definitions_[result_id] == kNoDefinition)
+        {
+            definitions_[result_id] = static_cast<uint32_t>(opcodes_.size());
+        }
+
+        word_offsets_.push_back(static_cast<uint32_t>(offset));
+        opcodes_.push_back(opcode);
+        result_ids_.push_back(result_id);
+        type_ids_.push_back(type_id);
+
+        offset += length;
+    }
+
+    words_    = spirv_code;
+    id_bound_ = id_bound;
+    return Status::SUCCESS;
+}
+
+void SpirVInstructionTable::Clear()
+{
+    words_    = nullptr;
+    id_bound_ = 0;
+    word_offsets_.clear();
+    opcodes_.clear();
+    result_ids_.clear();
+    type_ids_.clear();
+    definitions_.clear();
+}
+
+void SpirVInstructionTable::ShrinkToFit()
+{
+    word_offsets_.shrink_to_fit();
+    opcodes_.shrink_to_fit();
+    result_ids_.shrink_to_fit();
+    type_ids_.shrink_to_fit();
+    definitions_.shrink_to_fit();
+}
+
+size_t SpirVInstructionTable::used_bytes() const
+{
+    return (4 * size() + definitions_.size()) * sizeof(uint32_t);
+}
+
+size_t SpirVInstructionTable::retained_bytes() const
+{
+    return (word_offsets_.capacity() + opcodes_.capacity() + result_ids_.capacity() + type_ids_.capacity() +
+            definitions_.capacity()) *
+           sizeof(uint32_t);
+}
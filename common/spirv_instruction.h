@@ -0,0 +1,237 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_INSTRUCTION_H
+#define SPIRV_PARSING_COMMON_SPIRV_INSTRUCTION_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "spirv.hpp"
+
+class SpirVInstructionTable;
+
+// SpirVInstruction represents a single Spv::Op instruction.
+//
+// It is a view into a SpirVInstructionTable (and through it into the SPIR-V binary), so both have to outlive it.
+// A default constructed instruction is invalid, which is what lookups return when nothing was found.
+class SpirVInstruction
+{
+  public:
+    SpirVInstruction() = default;
+    SpirVInstruction(const SpirVInstructionTable* table, uint32_t index) : table_(table), index_(index) {}
+
+    //! false if this doesn't refer to an instruction
+    explicit operator bool() const { return table_ != nullptr; }
+
+    //! position in the table, instructions are numbered in module order
+    [[nodiscard]] uint32_t index() const { return index_; }
+
+    //! offset of the instruction's first word in the module, counted from the start of the header
+    [[nodiscard]] uint32_t word_offset() const;
+
+    //! the word used to define the Instruction
+    [[nodiscard]] uint32_t word(uint32_t index) const;
+
+    //! skips pass any optional Result or Result Type word
+    [[nodiscard]] uint32_t operand(uint32_t index) const { return word(operand_index() + index); }
+
+    //! number of words used as operands
+    [[nodiscard]] uint32_t num_operands() const { return length() - operand_index(); }
+
+    //! length of instruction in words
+    [[nodiscard]] uint32_t length() const { return word(0) >> 16; }
+
+    //! the instruction's op-code
+    [[nodiscard]] uint32_t opcode() const;
+
+    //! operand id, return 0 if no result
+    [[nodiscard]] uint32_t resultId() const;
+
+    //! operand id, return 0 if no type
+    [[nodiscard]] uint32_t typeId() const;
+
+    //! literal string starting at operand 'index', nullptr if the instruction has no such operand or the literal
+    //! isn't NUL-terminated inside the instruction (a malformed module), so the string never runs past it
+    [[nodiscard]] const char* operand_string(uint32_t index) const;
+
+    //! constant values can safely be returned as uint32_t
+    [[nodiscard]] uint32_t constant_value() const
+    {
+        assert(opcode() == spv::OpConstant);
+        return word(3);
+    }
+
+  private:
+    // first operand after the opcode and the optional Result Type and Result words
+    [[nodiscard]] uint32_t operand_index() const { return 1 + (typeId() != 0 ? 1 : 0) + (resultId() != 0 ? 1 : 0); }
+
+    const SpirVInstructionTable* table_ = nullptr;
+    uint32_t                     index_ = 0;
+};
+
+// SpirVInstructionTable splits a SPIR-V binary into its instructions with a single pass over the words.
+//
+// The table is stored as parallel arrays (word offset, opcode, result ID, type ID), 16 bytes per instruction with no
+// per-instruction allocations, so filtering on opcodes only touches the contiguous opcode array. Result IDs are
+// also indexed (bounded by the header's ID bound) to find the instruction defining an ID.
+//
+// The words are not copied, the SPIR-V binary has to outlive the table. A table can be rebuilt for the next module,
+// reusing its arrays.
+class SpirVInstructionTable
+{
+  public:
+    enum class Status
+    {
+        SUCCESS = 0,
+
+        //! the binary is too small to hold the 5 word header
+        TOO_SMALL,
+
+        //! the header's ID bound is larger than any implementation allows
+        INVALID_ID_BOUND,
+
+        //! an instruction has a zero length or runs past the end of the binary
+        INVALID_INSTRUCTION_LENGTH
+    };
+
+    //! spirv-header is 5 d-words
+    static constexpr uint32_t kHeaderSize = 5;
+
+    //! word 3 of the header is the ID bound, all result IDs are below it
+    static constexpr uint32_t kIdBoundWordIndex = 3;
+    static constexpr uint32_t kMaxIdBound       = 0x3FFFFF;
+
+    //! (re)build the table for a module, on failure the table is left empty
+    //! 'num_instructions_hint' (e.g. from SpirVScanner::Scan) sizes the arrays up front, 0 makes a rough guess
+    Status Build(const uint32_t* spirv_code, size_t spirv_num_bytes, size_t num_instructions_hint = 0);
+
+    //! drop the module, keeping the allocations for the next Build()
+    void Clear();
+
+    //! release the capacity past what the current module needs, e.g. when a SpirVRetentionPolicy asks for it
+    void ShrinkToFit();
+
+    //! bytes the current module needs, and bytes held for the next Build()
+    [[nodiscard]] size_t used_bytes() const;
+    [[nodiscard]] size_t retained_bytes() const;
+
+    [[nodiscard]] size_t   size() const { return opcodes_.size(); }
+    [[nodiscard]] uint32_t id_bound() const { return id_bound_; }
+
+    [[nodiscard]] SpirVInstruction operator[](size_t index) const
+    {
+        return SpirVInstruction(this, static_cast<uint32_t>(index));
+    }
+
+    //! the instruction defining 'id', invalid if there is none
+    [[nodiscard]] SpirVInstruction FindDef(uint32_t id) const
+    {
+        return id < definitions_.size() && definitions_[id] != kNoDefinition ? (*this)[definitions_[id]]
+                                                                             : SpirVInstruction();
+    }
+
+    //! the columns, one entry per instruction
+    [[nodiscard]] const std::vector<uint32_t>& word_offsets() const { return word_offsets_; }
+    [[nodiscard]] const std::vector<uint32_t>& opcodes() const { return opcodes_; }
+    [[nodiscard]] const std::vector<uint32_t>& result_ids() const { return result_ids_; }
+    [[nodiscard]] const std::vector<uint32_t>& type_ids() const { return type_ids_; }
+
+    class Iterator
+    {
+      public:
+        Iterator(const SpirVInstructionTable* table, uint32_t index) : table_(table), index_(index) {}
+
+        SpirVInstruction operator*() const { return SpirVInstruction(table_, index_); }
+        Iterator&        operator++()
+        {
+            ++index_;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+
+      private:
+        const SpirVInstructionTable* table_ = nullptr;
+        uint32_t                     index_ = 0;
+    };
+
+    [[nodiscard]] Iterator begin() const { return Iterator(this, 0); }
+    [[nodiscard]] Iterator end() const { return Iterator(this, static_cast<uint32_t>(size())); }
+
+  private:
+    friend class SpirVInstruction;
+
+    static constexpr uint32_t kNoDefinition = 0xFFFFFFFF;
+
+    const uint32_t* words_    = nullptr;
+    uint32_t        id_bound_ = 0;
+
+    std::vector<uint32_t> word_offsets_{};
+    std::vector<uint32_t> opcodes_{};
+    std::vector<uint32_t> result_ids_{};
+    std::vector<uint32_t> type_ids_{};
+
+    // instruction index per result ID
+    std::vector<uint32_t> definitions_{};
+};
+
+inline uint32_t SpirVInstruction::word_offset() const
+{
+    return table_->word_offsets_[index_];
+}
+
+inline uint32_t SpirVInstruction::word(uint32_t index) const
+{
+    return table_->words_[table_->word_offsets_[index_] + index];
+}
+
+inline uint32_t SpirVInstruction::opcode() const
+{
+    return table_->opcodes_[index_];
+}
+
+inline uint32_t SpirVInstruction::resultId() const
+{
+    return table_->result_ids_[index_];
+}
+
+inline uint32_t SpirVInstruction::typeId() const
+{
+    return table_->type_ids_[index_];
+}
+
+inline const char* SpirVInstruction::operand_string(uint32_t index) const
+{
+    const uint32_t first  = operand_index() + index;
+    const uint32_t length = this->length();
+    if (first >= length)
+    {
+        return nullptr;
+    }
+    const char* string = reinterpret_cast<const char*>(table_->words_ + table_->word_offsets_[index_] + first);
+    return memchr(string, '\0', (length - first) * sizeof(uint32_t)) != nullptr ? string : nullptr;
+}
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_INSTRUCTION_H
@@ -0,0 +1,145 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_MEMBER_MAP_H
+#define SPIRV_PARSING_COMMON_SPIRV_MEMBER_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// SpirVMemberMap maps a (struct ID, member index) pair to a value, e.g. the OpMemberName string or the member's
+// decorations.
+//
+// It is an open-addressing table in a single vector. Clear() keeps the slots, so an analyzer reused for modules of a
+// similar size doesn't allocate per member the way a node-based std::unordered_map does.
+template <typename Value>
+class SpirVMemberMap
+{
+  public:
+    //! drop all entries, keeping the allocated slots
+    void Clear()
+    {
+        for (Slot& slot : slots_)
+        {
+            slot.key = kEmptyKey;
+        }
+        size_ = 0;
+    }
+
+    //! the value of a member, default constructed on first use
+    Value& operator[](uint64_t key)
+    {
+        if ((size_ + 1) * 2 > slots_.size())
+        {
+            Grow();
+        }
+        Slot& slot = slots_[FindSlot(key)];
+        if (slot.key == kEmptyKey)
+        {
+            slot.key   = key;
+            slot.value = Value();
+            size_++;
+        }
+        return slot.value;
+    }
+
+    Value& operator()(uint32_t struct_id, uint32_t member) { return (*this)[Key(struct_id, member)]; }
+
+    //! nullptr if the member has no entry
+    [[nodiscard]] const Value* Find(uint32_t struct_id, uint32_t member) const
+    {
+        if (slots_.empty())
+        {
+            return nullptr;
+        }
+        const Slot& slot = slots_[FindSlot(Key(struct_id, member))];
+        return slot.key != kEmptyKey ? &slot.value : nullptr;
+    }
+
+    //! make room for 'count' entries without growing
+    void Reserve(size_t count)
+    {
+        if (count * 2 > slots_.size())
+        {
+            Rehash(count * 2);
+        }
+    }
+
+    //! release the slots past what the current entries need
+    void ShrinkToFit() { Rehash(size_ * 2); }
+
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] size_t used_bytes() const { return size_ * 2 * sizeof(Slot); }
+    [[nodiscard]] size_t retained_bytes() const { return slots_.capacity() * sizeof(Slot); }
+
+    static uint64_t Key(uint32_t struct_id, uint32_t member) { return (static_cast<uint64_t>(struct_id) << 32) | member; }
+
+  private:
+    // IDs are below the ID bound (at most 0x3FFFFF), so no member key has all bits set
+    static constexpr uint64_t kEmptyKey = ~0ull;
+
+    struct Slot
+    {
+        uint64_t key = kEmptyKey;
+        Value    value{};
+    };
+
+    // linear probing, the table is a power of two and at most half full so this always ends
+    [[nodiscard]] size_t FindSlot(uint64_t key) const
+    {
+        const size_t mask  = slots_.size() - 1;
+        size_t       index = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        while (slots_[index].key != kEmptyKey && slots_[index].key != key)
+        {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    void Grow() { Rehash(slots_.empty() ? 16 : slots_.size() * 2); }
+
+    void Rehash(size_t min_slots)
+    {
+        size_t num_slots = 16;
+        while (num_slots < min_slots)
+        {
+            num_slots *= 2;
+        }
+
+        std::vector<Slot> old_slots;
+        old_slots.swap(slots_);
+        slots_.resize(num_slots);
+        for (const Slot& slot : old_slots)
+        {
+            if (slot.key != kEmptyKey)
+            {
+                slots_[FindSlot(slot.key)] = slot;
+            }
+        }
+    }
+
+    std::vector<Slot> slots_{};
+    size_t            size_ = 0;
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_MEMBER_MAP_H
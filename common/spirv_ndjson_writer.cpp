@@ -0,0 +1,290 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_ndjson_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+bool IsContinuation(unsigned char c)
+{
+    return (c & 0xC0) == 0x80;
+}
+
+// bytes in the well-formed UTF-8 sequence at 'text' (Unicode table 3-7), 0 for anything else: stray continuation
+// bytes, overlong forms, UTF-16 surrogates, code points above U+10FFFF and sequences cut short by the terminator
+size_t Utf8SequenceLength(const unsigned char* text)
+{
+    const unsigned char lead = text[0];
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        return IsContinuation(text[1]) ? 2 : 0;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        const unsigned char low  = lead == 0xE0 ? 0xA0 : 0x80;
+        const unsigned char high = lead == 0xED ? 0x9F : 0xBF;
+        return text[1] >= low && text[1] <= high && IsContinuation(text[2]) ? 3 : 0;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        const unsigned char low  = lead == 0xF0 ? 0x90 : 0x80;
+        const unsigned char high = lead == 0xF4 ? 0x8F : 0xBF;
+        return text[1] >= low && text[1] <= high && IsContinuation(text[2]) && IsContinuation(text[3]) ? 4 : 0;
+    }
+    return 0;
+}
+}  // namespace
+
+SpirVNdjsonWriter::SpirVNdjsonWriter(FILE* output, size_t buffer_size)
+    : output_(output), buffer_(buffer_size > 0 ? buffer_size : 1), first_(kInitialDepth, true)
+{
+}
+
+SpirVNdjsonWriter::~SpirVNdjsonWriter()
+{
+    Flush();
+}
+
+void SpirVNdjsonWriter::SetOutput(FILE* output)
+{
+    Flush();
+    output_ = output;
+}
+
+void SpirVNdjsonWriter::SetRecordField(const char* key, const char* value)
+{
+    record_key_   = key;
+    record_value_ = value;
+}
+
+void SpirVNdjsonWriter::AppendRecords(const char* records, size_t length)
+{
+    const char* const end = records + length;
+    while (records < end)
+    {
+        const char* line_end = static_cast<const char*>(memchr(records, '\n', static_cast<size_t>(end - records)));
+        line_end             = line_end ? line_end + 1 : end;
+
+        if (record_key_ && *records == '{')
+        {
+            Put('{');
+            PutEscaped(record_key_);
+            Put(':');
+            PutEscaped(record_value_ ? record_value_ : "");
+            records++;
+            if (records < line_end && *records != '}')
+            {
+                Put(',');
+            }
+        }
+        Put(records, static_cast<size_t>(line_end - records));
+        records = line_end;
+    }
+}
+
+void SpirVNdjsonWriter::Flush()
+{
+    if (used_ > 0 && output_)
+    {
+        fwrite(buffer_.data(), 1, used_, output_);
+    }
+    used_ = 0;
+}
+
+void SpirVNdjsonWriter::Reset()
+{
+    used_     = 0;
+    depth_    = 0;
+    first_[0] = true;
+}
+
+void SpirVNdjsonWriter::Put(const char* text, size_t length)
+{
+    while (length > 0)
+    {
+        if (used_ == buffer_.size())
+        {
+            Flush();
+        }
+        const size_t chunk = std::min(length, buffer_.size() - used_);
+        memcpy(buffer_.data() + used_, text, chunk);
+        used_ += chunk;
+        text += chunk;
+        length -= chunk;
+    }
+}
+
+void SpirVNdjsonWriter::PutEscaped(const char* text)
+{
+    static const char kHexDigits[] = "0123456789abcdef";
+
+    Put('"');
+    // runs of characters that need no escaping are copied in one go
+    const char* run = text;
+    for (; *text != '\0'; text++)
+    {
+        const auto c = static_cast<unsigned char>(*text);
+        if (c >= 0x80)
+        {
+            // the short-circuit in Utf8SequenceLength() never reads past the terminator
+            const size_t length = Utf8SequenceLength(reinterpret_cast<const unsigned char*>(text));
+            if (length > 0)
+            {
+                text += length - 1;
+                continue;
+            }
+            Put(run, static_cast<size_t>(text - run));
+            run = text + 1;
+            Put("\\ufffd", 6);
+            continue;
+        }
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue;
+        }
+        Put(run, static_cast<size_t>(text - run));
+        run = text + 1;
+
+        Put('\\');
+        switch (c)
+        {
+            case '"':
+            case '\\':
+                Put(static_cast<char>(c));
+                break;
+            case '\n':
+                Put('n');
+                break;
+            case '\t':
+                Put('t');
+                break;
+            default:
+                Put("u00", 3);
+                Put(kHexDigits[c >> 4]);
+                Put(kHexDigits[c & 0xF]);
+                break;
+        }
+    }
+    Put(run, static_cast<size_t>(text - run));
+    Put('"');
+}
+
+void SpirVNdjsonWriter::BeginValue(const char* key)
+{
+    if (!first_[depth_])
+    {
+        Put(',');
+    }
+    first_[depth_] = false;
+    if (key)
+    {
+        PutEscaped(key);
+        Put(':');
+    }
+}
+
+void SpirVNdjsonWriter::BeginObject(const char* key)
+{
+    const bool is_record = depth_ == 0;
+    if (!is_record)
+    {
+        BeginValue(key);
+    }
+    Put('{');
+    Enter();
+    if (is_record && record_key_)
+    {
+        String(record_key_, record_value_);
+    }
+}
+
+void SpirVNdjsonWriter::EndObject()
+{
+    Put('}');
+    Leave();
+    if (depth_ == 0)
+    {
+        // the record is complete, the next one starts a new line
+        Put('\n');
+        first_[0] = true;
+    }
+}
+
+void SpirVNdjsonWriter::BeginArray(const char* key)
+{
+    BeginValue(key);
+    Put('[');
+    Enter();
+}
+
+void SpirVNdjsonWriter::EndArray()
+{
+    Put(']');
+    Leave();
+}
+
+void SpirVNdjsonWriter::Enter()
+{
+    if (++depth_ == first_.size())
+    {
+        first_.push_back(true);
+    }
+    first_[depth_] = true;
+}
+
+void SpirVNdjsonWriter::String(const char* key, const char* value)
+{
+    BeginValue(key);
+    PutEscaped(value ? value : "");
+}
+
+void SpirVNdjsonWriter::UInt(const char* key, uint64_t value)
+{
+    BeginValue(key);
+
+    // digits are produced backwards into a buffer large enough for any 64-bit value
+    char  digits[20];
+    char* end   = digits + sizeof(digits);
+    char* begin = end;
+    do
+    {
+        *--begin = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    Put(begin, static_cast<size_t>(end - begin));
+}
+
+void SpirVNdjsonWriter::Bool(const char* key, bool value)
+{
+    BeginValue(key);
+    if (value)
+    {
+        Put("true", 4);
+    }
+    else
+    {
+        Put("false", 5);
+    }
+}
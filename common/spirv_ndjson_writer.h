@@ -0,0 +1,112 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_NDJSON_WRITER_H
+#define SPIRV_PARSING_COMMON_SPIRV_NDJSON_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// SpirVNdjsonWriter streams newline-delimited JSON, one object per line, into a fixed buffer that is written to a
+// FILE* whenever it fills up.
+//
+// Values are escaped straight into the buffer, so emitting a record never allocates and strings of any length pass
+// through whole. Strings are taken as UTF-8 and every invalid sequence (e.g. in an OpName) is written as U+FFFD, so
+// the output is always valid JSON. The writer only tracks commas, to any depth; callers are trusted to balance
+// Begin/End and to pass keys inside objects and none inside arrays.
+class SpirVNdjsonWriter
+{
+  public:
+    explicit SpirVNdjsonWriter(FILE* output = stdout, size_t buffer_size = 64 * 1024);
+    ~SpirVNdjsonWriter();
+
+    SpirVNdjsonWriter(const SpirVNdjsonWriter&)            = delete;
+    SpirVNdjsonWriter& operator=(const SpirVNdjsonWriter&) = delete;
+
+    //! flush what was written so far and continue on 'output'
+    void SetOutput(FILE* output);
+
+    //! start every record from now on with "key": "value", e.g. the file the records are about. nullptr stops it,
+    //! the strings must stay valid until then
+    void SetRecordField(const char* key, const char* value);
+
+    //! copy complete records written by another writer (without a record field), adding the record field to each
+    void AppendRecords(const char* records, size_t length);
+
+    //! 'key' is nullptr for the record itself and for objects inside arrays. Ending the record ends the line
+    void BeginObject(const char* key = nullptr);
+    void EndObject();
+
+    void BeginArray(const char* key = nullptr);
+    void EndArray();
+
+    void String(const char* key, const char* value);
+    void UInt(const char* key, uint64_t value);
+    void Bool(const char* key, bool value);
+
+    //! the same, as elements of the current array
+    void String(const char* value) { String(nullptr, value); }
+    void UInt(uint64_t value) { UInt(nullptr, value); }
+
+    //! write the buffer to the output, also done when the writer is destroyed
+    void Flush();
+
+    //! drop what wasn't flushed yet and start over at the record level, e.g. after a report was cut short
+    void Reset();
+
+  private:
+    // nesting deeper than this grows first_, the only allocation after construction
+    static constexpr size_t kInitialDepth = 16;
+
+    // separator and key in front of every value
+    void BeginValue(const char* key);
+
+    void Put(char c)
+    {
+        if (used_ == buffer_.size())
+        {
+            Flush();
+        }
+        buffer_[used_++] = c;
+    }
+    void Put(const char* text, size_t length);
+    void PutEscaped(const char* text);
+
+    FILE*             output_ = nullptr;
+    std::vector<char> buffer_{};
+    size_t            used_ = 0;
+
+    const char* record_key_   = nullptr;
+    const char* record_value_ = nullptr;
+
+    // per nesting level, whether the next value is the first of its object/array
+    std::vector<bool> first_{};
+    size_t            depth_ = 0;
+
+    // open a level and return to the enclosing one, an unbalanced End*() stays at the record level
+    void Enter();
+    void Leave() { depth_ = depth_ > 0 ? depth_ - 1 : 0; }
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_NDJSON_WRITER_H
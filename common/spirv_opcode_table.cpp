@@ -0,0 +1,50 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_opcode_table.h"
+
+#include "helper.h"
+#include "spirv.hpp"
+
+// the largest opcode in spirv.hpp, update together with the SPIR-V headers
+static_assert(spv::OpMaskedScatterINTEL < SpirVOpcodeTable::kNumOpcodes, "opcode table is too small for spirv.hpp");
+
+namespace
+{
+constexpr uint32_t kNumOpcodes = SpirVOpcodeTable::kNumOpcodes;
+
+template <typename Table>
+constexpr Table Generate()
+{
+    Table table{};
+    for (uint32_t opcode = 0; opcode < kNumOpcodes; ++opcode)
+    {
+        const uint32_t properties = (OpcodeHasType(opcode) ? SpirVOpcodeTable::HAS_TYPE : 0u) |
+                                    (OpcodeHasResult(opcode) ? SpirVOpcodeTable::HAS_RESULT : 0u);
+        table.packed[opcode / 4] |= static_cast<uint8_t>(properties << ((opcode % 4) * 2));
+    }
+    return table;
+}
+} // namespace
+
+// constant-initialized, nothing runs at startup
+const SpirVOpcodeTable::Table SpirVOpcodeTable::kTable = Generate<SpirVOpcodeTable::Table>();
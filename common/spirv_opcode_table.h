@@ -0,0 +1,64 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_OPCODE_TABLE_H
+#define SPIRV_PARSING_COMMON_SPIRV_OPCODE_TABLE_H
+
+#include <cstdint>
+
+// SpirVOpcodeTable packs the has-type/has-result properties of every opcode into 2 bits, so decoding an instruction
+// is a table load and a shift instead of walking the big switches in helper.h.
+//
+// The table is generated at compile time from OpcodeHasType()/OpcodeHasResult(), so it always matches helper.h
+// (and with it the grammar helper.h is generated from). That happens in spirv_opcode_table.cpp, so helper.h and its
+// static functions stay out of every file that decodes instructions.
+class SpirVOpcodeTable
+{
+  public:
+    enum Property : uint32_t
+    {
+        HAS_TYPE   = 0x1,
+        HAS_RESULT = 0x2
+    };
+
+    //! every opcode in spirv.hpp is below this, larger opcodes have no properties
+    static constexpr uint32_t kNumOpcodes = 8192;
+
+    //! HAS_TYPE/HAS_RESULT bits of 'opcode', without branching
+    [[nodiscard]] static uint32_t GetProperties(uint32_t opcode)
+    {
+        // unknown opcodes all map to the last, empty, entry
+        const uint32_t index = opcode < kNumOpcodes ? opcode : kNumOpcodes;
+        return (kTable.packed[index / 4] >> ((index % 4) * 2)) & 0x3u;
+    }
+
+  private:
+    struct Table
+    {
+        // 4 opcodes per byte, plus one byte for the unknown-opcode entry
+        uint8_t packed[kNumOpcodes / 4 + 1];
+    };
+
+    static const Table kTable;
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_OPCODE_TABLE_H
@@ -0,0 +1,281 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_result_cache.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace
+{
+// bump whenever the entry layout changes, older entries are then treated as misses
+constexpr uint32_t kFormatVersion = 1;
+constexpr char     kMagic[4]      = {'S', 'P', 'R', 'C'};
+
+constexpr uint32_t kFlagFailed = 0x1;
+
+struct EntryHeader
+{
+    char     magic[4];
+    uint32_t format_version;
+    uint64_t module_hash;
+    uint64_t tool_hash;
+    uint64_t module_bytes;
+    uint64_t payload_bytes;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(EntryHeader) == SpirVResultCache::kPayloadOffset,
+              "the payload offset is part of the entry format");
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t RotateLeft(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Read64(const unsigned char* p)
+{
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t Read32(const unsigned char* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t Round(uint64_t accumulator, uint64_t input)
+{
+    accumulator += input * kPrime2;
+    accumulator = RotateLeft(accumulator, 31);
+    return accumulator * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t hash, uint64_t accumulator)
+{
+    hash ^= Round(0, accumulator);
+    return hash * kPrime1 + kPrime4;
+}
+
+void AppendHex(std::string& out, uint64_t value)
+{
+    static const char kDigits[] = "0123456789abcdef";
+    for (int shift = 60; shift >= 0; shift -= 4)
+    {
+        out.push_back(kDigits[(value >> shift) & 0xF]);
+    }
+}
+}  // namespace
+
+SpirVResultCache::SpirVResultCache(std::string directory, const std::string& tool_key)
+    : directory_(std::move(directory)), tool_hash_(Hash(tool_key.data(), tool_key.size()))
+{
+}
+
+uint64_t SpirVResultCache::Hash(const void* data, size_t num_bytes, uint64_t seed)
+{
+    const auto*          p   = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + num_bytes;
+
+    uint64_t hash;
+    if (num_bytes >= 32)
+    {
+        // four independent lanes, so the multiplies of one stripe overlap
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        const unsigned char* const last_stripe = end - 32;
+        do
+        {
+            v1 = Round(v1, Read64(p));
+            v2 = Round(v2, Read64(p + 8));
+            v3 = Round(v3, Read64(p + 16));
+            v4 = Round(v4, Read64(p + 24));
+            p += 32;
+        } while (p <= last_stripe);
+
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    }
+    else
+    {
+        hash = seed + kPrime5;
+    }
+
+    hash += static_cast<uint64_t>(num_bytes);
+
+    for (; p + 8 <= end; p += 8)
+    {
+        hash ^= Round(0, Read64(p));
+        hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end)
+    {
+        hash ^= static_cast<uint64_t>(Read32(p)) * kPrime1;
+        hash = RotateLeft(hash, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; p++)
+    {
+        hash ^= static_cast<uint64_t>(*p) * kPrime5;
+        hash = RotateLeft(hash, 11) * kPrime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+SpirVResultCache::Key SpirVResultCache::KeyOf(const uint32_t* words, size_t num_bytes)
+{
+    Key key;
+    key.module_hash  = Hash(words, num_bytes);
+    key.module_bytes = num_bytes;
+    return key;
+}
+
+std::string SpirVResultCache::EntryPath(const Key& key) const
+{
+    // the first byte of the hash picks a subdirectory, so no single directory grows too large
+    std::string name;
+    name.reserve(32);
+    AppendHex(name, key.module_hash);
+    AppendHex(name, tool_hash_);
+
+    std::string path = directory_;
+    path += '/';
+    path.append(name, 0, 2);
+    path += '/';
+    path += name;
+    return path;
+}
+
+bool SpirVResultCache::Load(const Key& key, Entry& entry) const
+{
+    FILE* file = fopen(EntryPath(key).c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    EntryHeader header;
+    bool        valid = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, kMagic, 4) == 0 &&
+                 header.format_version == kFormatVersion && header.module_hash == key.module_hash &&
+                 header.tool_hash == tool_hash_ && header.module_bytes == key.module_bytes;
+    if (valid)
+    {
+        // the size comes from disk, an entry that doesn't hold exactly that many bytes is corrupt and a miss
+        const long payload_start = ftell(file);
+        long       file_size     = -1;
+        if (payload_start >= 0 && fseek(file, 0, SEEK_END) == 0)
+        {
+            file_size = ftell(file);
+        }
+        valid = file_size >= payload_start && fseek(file, payload_start, SEEK_SET) == 0 &&
+                header.payload_bytes == static_cast<uint64_t>(file_size - payload_start);
+    }
+    if (valid)
+    {
+        entry.payload.resize(static_cast<size_t>(header.payload_bytes));
+        valid = entry.payload.empty() || fread(entry.payload.data(), entry.payload.size(), 1, file) == 1;
+        entry.failed = (header.flags & kFlagFailed) != 0;
+    }
+    fclose(file);
+    return valid;
+}
+
+bool SpirVResultCache::Store(const Key& key, const Entry& entry) const
+{
+    const std::string path = EntryPath(key);
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    if (error)
+    {
+        return false;
+    }
+
+    // unique per process, thread and call, so writers never share a temporary file
+    static std::atomic<uint64_t> temp_counter{0};
+    std::string                  temp_path = path;
+    temp_path += ".tmp.";
+#if defined(__unix__) || defined(__APPLE__)
+    AppendHex(temp_path, static_cast<uint64_t>(getpid()));
+    temp_path += '.';
+#endif
+    AppendHex(temp_path, std::hash<std::thread::id>()(std::this_thread::get_id()));
+    temp_path += '.';
+    AppendHex(temp_path, temp_counter.fetch_add(1, std::memory_order_relaxed));
+
+    FILE* file = fopen(temp_path.c_str(), "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    EntryHeader header{};
+    memcpy(header.magic, kMagic, 4);
+    header.format_version = kFormatVersion;
+    header.module_hash    = key.module_hash;
+    header.tool_hash      = tool_hash_;
+    header.module_bytes   = key.module_bytes;
+    header.payload_bytes  = entry.payload.size();
+    header.flags          = entry.failed ? kFlagFailed : 0;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   (entry.payload.empty() || fwrite(entry.payload.data(), entry.payload.size(), 1, file) == 1);
+    written      = (fclose(file) == 0) && written;
+
+    // rename replaces an existing entry atomically, readers see the old or the new file but never a partial one
+    if (!written || std::rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
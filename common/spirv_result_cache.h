@@ -0,0 +1,83 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_RESULT_CACHE_H
+#define SPIRV_PARSING_COMMON_SPIRV_RESULT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// SpirVResultCache keeps analysis results on disk, keyed by the content of the module, so a module that was analyzed
+// before (by any run, on any machine sharing the directory) is answered without parsing it again.
+//
+// Each entry is one file named after the hash of the module words and the hash of the tool key. The tool key names
+// the tool, its result version and every option that changes the result, so different tools and settings can share
+// a directory. Entries are written to a temporary file and renamed into place, so concurrent workers and processes
+// never see a partial entry; when two of them store the same module, the last rename wins with identical content.
+class SpirVResultCache
+{
+  public:
+    struct Key
+    {
+        uint64_t module_hash  = 0;
+        uint64_t module_bytes = 0;
+    };
+
+    //! an entry file is a fixed header followed by the payload, so the payload starts at this 8-byte aligned offset.
+    //! Consumers can map EntryPath() and read a payload in place, e.g. a flat buffer-reference file
+    static constexpr size_t kPayloadOffset = 48;
+
+    struct Entry
+    {
+        //! the tool's report for the module
+        std::string payload{};
+        //! the analysis failed, cached as well since it is just as deterministic
+        bool failed = false;
+    };
+
+    //! 'directory' is created on the first Store()
+    SpirVResultCache(std::string directory, const std::string& tool_key);
+
+    //! 64-bit hash of 'num_bytes' bytes (the XXH64 algorithm)
+    static uint64_t Hash(const void* data, size_t num_bytes, uint64_t seed = 0);
+
+    //! key of a module, hashing its words
+    static Key KeyOf(const uint32_t* words, size_t num_bytes);
+
+    //! false if there is no entry, or it was written by another format version or does not match the module size
+    bool Load(const Key& key, Entry& entry) const;
+
+    //! returns false if the entry could not be written, the cache is only an optimization so callers can go on
+    bool Store(const Key& key, const Entry& entry) const;
+
+    [[nodiscard]] const std::string& directory() const { return directory_; }
+
+    //! file holding the entry of 'key', whether or not it exists
+    [[nodiscard]] std::string EntryPath(const Key& key) const;
+
+  private:
+    std::string directory_;
+    uint64_t    tool_hash_ = 0;
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_RESULT_CACHE_H
@@ -0,0 +1,110 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_RESULT_RING_H
+#define SPIRV_PARSING_COMMON_SPIRV_RESULT_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// SpirVResultRing is a single-producer/single-consumer ring of result records in memory owned by the caller.
+//
+// An analyzer pushes its results while the caller (possibly on another thread) pops them, so the results of a stream
+// of modules never need a container per module. Records are copied whole, a full ring rejects the record and counts
+// it in dropped() rather than blocking the analysis.
+template <typename Record>
+class SpirVResultRing
+{
+    static_assert(std::is_trivially_copyable<Record>::value, "records are copied into caller-owned memory");
+
+  public:
+    //! 'storage' holds 'capacity' records and stays owned by the caller. The capacity is rounded down to a power of
+    //! two, so indices wrap with a mask
+    SpirVResultRing(Record* storage, size_t capacity)
+        : storage_(capacity > 0 ? storage : nullptr), mask_(RoundDown(capacity) - 1)
+    {
+    }
+
+    SpirVResultRing(const SpirVResultRing&)            = delete;
+    SpirVResultRing& operator=(const SpirVResultRing&) = delete;
+
+    //! producer side, false if the ring is full
+    bool TryPush(const Record& record)
+    {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (storage_ == nullptr || tail - head_.load(std::memory_order_acquire) > mask_)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        storage_[tail & mask_] = record;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! consumer side, false if the ring is empty
+    bool TryPop(Record& record)
+    {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        record = storage_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! records pushed but not popped yet
+    [[nodiscard]] size_t size() const
+    {
+        return static_cast<size_t>(tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire));
+    }
+
+    [[nodiscard]] size_t capacity() const { return storage_ ? mask_ + 1 : 0; }
+
+    //! records rejected because the ring was full
+    [[nodiscard]] uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  private:
+    static size_t RoundDown(size_t capacity)
+    {
+        size_t power = 1;
+        while (power <= capacity / 2)
+        {
+            power *= 2;
+        }
+        return power;
+    }
+
+    Record* storage_ = nullptr;
+    size_t  mask_    = 0;
+
+    // on separate cache lines, each is written by one side only
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_RESULT_RING_H
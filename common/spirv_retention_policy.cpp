@@ -0,0 +1,53 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_retention_policy.h"
+
+#include <algorithm>
+
+SpirVRetentionPolicy SpirVRetentionPolicy::HighWaterMark(size_t window, size_t max_ratio, size_t min_retained_bytes)
+{
+    SpirVRetentionPolicy policy;
+    policy.window_             = std::max<size_t>(window, 1);
+    policy.max_ratio_          = std::max<size_t>(max_ratio, 1);
+    policy.min_retained_bytes_ = min_retained_bytes;
+    return policy;
+}
+
+bool SpirVRetentionPolicy::Update(size_t used_bytes, size_t retained_bytes)
+{
+    if (!enabled())
+    {
+        return false;
+    }
+
+    current_high_water_ = std::max(current_high_water_, used_bytes);
+    if (++num_modules_in_window_ == window_)
+    {
+        previous_high_water_   = current_high_water_;
+        current_high_water_    = 0;
+        num_modules_in_window_ = 0;
+    }
+
+    const size_t high_water = std::max(current_high_water_, previous_high_water_);
+    return retained_bytes > min_retained_bytes_ && retained_bytes / max_ratio_ > high_water;
+}
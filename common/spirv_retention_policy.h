@@ -0,0 +1,62 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_RETENTION_POLICY_H
+#define SPIRV_PARSING_COMMON_SPIRV_RETENTION_POLICY_H
+
+#include <cstddef>
+
+// SpirVRetentionPolicy decides when a reused analyzer gives memory back.
+//
+// An analyzer keeps its tables between modules, so a batch of similar-sized modules is analyzed without allocating.
+// The flip side is that the tables stay at the size of the largest module seen, which with a batch started
+// largest-first is the whole run. The high-water-mark policy remembers how much the recent modules needed and asks
+// for a trim once the retained memory is several times that.
+class SpirVRetentionPolicy
+{
+  public:
+    //! never trims, the default
+    SpirVRetentionPolicy() = default;
+
+    //! trim once more than 'max_ratio' times the high-water mark of the last 'window' modules is retained, ignoring
+    //! anything below 'min_retained_bytes'
+    static SpirVRetentionPolicy HighWaterMark(size_t window             = 32,
+                                              size_t max_ratio          = 4,
+                                              size_t min_retained_bytes = 1024 * 1024);
+
+    //! record one module, true if the caller should trim now
+    bool Update(size_t used_bytes, size_t retained_bytes);
+
+    [[nodiscard]] bool enabled() const { return window_ != 0; }
+
+  private:
+    size_t window_             = 0;
+    size_t max_ratio_          = 0;
+    size_t min_retained_bytes_ = 0;
+
+    // the mark is kept for the current and the previous window, so it never drops right after a window starts
+    size_t num_modules_in_window_ = 0;
+    size_t current_high_water_    = 0;
+    size_t previous_high_water_   = 0;
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_RETENTION_POLICY_H
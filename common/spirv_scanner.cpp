@@ -0,0 +1,357 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_scanner.h"
+
+#include "spirv.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SPIRV_SCANNER_USE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+size_t CountOpcodeScalar(const uint32_t* opcodes, size_t count, uint32_t opcode)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        total += opcodes[i] == opcode ? 1 : 0;
+    }
+    return total;
+}
+
+size_t FindOpcodeScalar(const uint32_t* opcodes, size_t count, uint32_t opcode)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (opcodes[i] == opcode)
+        {
+            return i;
+        }
+    }
+    return count;
+}
+
+#ifdef SPIRV_SCANNER_USE_X86_SIMD
+
+__attribute__((target("avx2"))) size_t CountOpcodeAvx2(const uint32_t* opcodes, size_t count, uint32_t opcode)
+{
+    const __m256i needle = _mm256_set1_epi32(static_cast<int>(opcode));
+    size_t        total  = 0;
+    size_t        i      = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(opcodes + i));
+        const int     mask  = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(words, needle)));
+        total += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+    }
+    return total + CountOpcodeScalar(opcodes + i, count - i, opcode);
+}
+
+__attribute__((target("avx2"))) size_t FindOpcodeAvx2(const uint32_t* opcodes, size_t count, uint32_t opcode)
+{
+    const __m256i needle = _mm256_set1_epi32(static_cast<int>(opcode));
+    size_t        i      = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(opcodes + i));
+        const int     mask  = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(words, needle)));
+        if (mask != 0)
+        {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return i + FindOpcodeScalar(opcodes + i, count - i, opcode);
+}
+
+__attribute__((target("sse4.2"))) size_t CountOpcodeSse42(const uint32_t* opcodes, size_t count, uint32_t opcode)
+{
+    const __m128i needle = _mm_set1_epi32(static_cast<int>(opcode));
+    size_t        total  = 0;
+    size_t        i      = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(opcodes + i));
+        const int     mask  = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(words, needle)));
+        total += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+    }
+    return total + CountOpcodeScalar(opcodes + i, count - i, opcode);
+}
+
+__attribute__((target("sse4.2"))) size_t FindOpcodeSse42(const uint32_t* opcodes, size_t count, uint32_t opcode)
+{
+    const __m128i needle = _mm_set1_epi32(static_cast<int>(opcode));
+    size_t        i      = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(opcodes + i));
+        const int     mask  = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(words, needle)));
+        if (mask != 0)
+        {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return i + FindOpcodeScalar(opcodes + i, count - i, opcode);
+}
+
+#endif // SPIRV_SCANNER_USE_X86_SIMD
+
+enum class SimdLevel
+{
+    SCALAR,
+    SSE42,
+    AVX2
+};
+
+SimdLevel DetectSimdLevel()
+{
+#ifdef SPIRV_SCANNER_USE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        return SimdLevel::SSE42;
+    }
+#endif
+    return SimdLevel::SCALAR;
+}
+
+// checked once, the CPU doesn't change while running
+SimdLevel GetCachedSimdLevel()
+{
+    static const SimdLevel simd_level = DetectSimdLevel();
+    return simd_level;
+}
+
+} // namespace
+
+SpirVScanner::OpcodeClass SpirVScanner::GetOpcodeClass(uint32_t opcode)
+{
+    switch (opcode)
+    {
+        case spv::OpCapability:
+            return CAPABILITY;
+
+        case spv::OpSourceContinued:
+        case spv::OpSource:
+        case spv::OpSourceExtension:
+        case spv::OpName:
+        case spv::OpMemberName:
+        case spv::OpString:
+        case spv::OpLine:
+        case spv::OpNoLine:
+        case spv::OpModuleProcessed:
+            return DEBUG;
+
+        case spv::OpDecorate:
+        case spv::OpMemberDecorate:
+        case spv::OpDecorationGroup:
+        case spv::OpGroupDecorate:
+        case spv::OpGroupMemberDecorate:
+        case spv::OpDecorateId:
+        case spv::OpDecorateString:
+        case spv::OpMemberDecorateString:
+            return ANNOTATION;
+
+        case spv::OpVariable:
+            return VARIABLE;
+
+        case spv::OpLoad:
+        case spv::OpStore:
+        case spv::OpCopyMemory:
+        case spv::OpCopyMemorySized:
+        case spv::OpAccessChain:
+        case spv::OpInBoundsAccessChain:
+        case spv::OpPtrAccessChain:
+        case spv::OpInBoundsPtrAccessChain:
+        case spv::OpCopyObject:
+        case spv::OpCopyLogical:
+        case spv::OpConvertUToPtr:
+        case spv::OpConvertPtrToU:
+            return MEMORY;
+
+        case spv::OpFunction:
+        case spv::OpFunctionParameter:
+        case spv::OpFunctionEnd:
+        case spv::OpFunctionCall:
+            return FUNCTION;
+
+        default:
+            break;
+    }
+
+    // the core types and constants have contiguous opcodes (OpTypeVoid..OpTypeForwardPointer, OpConstantTrue..)
+    if (opcode >= spv::OpTypeVoid && opcode <= spv::OpTypeForwardPointer)
+    {
+        return TYPE;
+    }
+    if (opcode >= spv::OpConstantTrue && opcode <= spv::OpSpecConstantOp)
+    {
+        return CONSTANT;
+    }
+    return OTHER;
+}
+
+SpirVScanner::Result SpirVScanner::Scan(const uint32_t* spirv_code, size_t spirv_num_bytes)
+{
+    Result result;
+
+    const size_t num_words = spirv_num_bytes / sizeof(uint32_t);
+    if (spirv_code == nullptr || num_words < kHeaderSize)
+    {
+        result.status = Status::TOO_SMALL;
+        return result;
+    }
+    result.id_bound = spirv_code[3];
+
+    bool   found_function = false;
+    size_t offset         = kHeaderSize;
+    while (offset < num_words)
+    {
+        const uint32_t first_word = spirv_code[offset];
+        const uint32_t length     = first_word >> 16;
+        const uint32_t opcode     = first_word & 0x0ffffu;
+        if (length == 0 || length > num_words - offset)
+        {
+            result.status = Status::INVALID_INSTRUCTION_LENGTH;
+            return result;
+        }
+
+        switch (opcode)
+        {
+            case spv::OpFunction:
+                if (!found_function)
+                {
+                    found_function                    = true;
+                    result.first_function_index       = result.num_instructions;
+                    result.first_function_word_offset = offset;
+                }
+                break;
+            case spv::OpName:
+                result.num_names++;
+                break;
+            case spv::OpMemberName:
+                result.num_member_names++;
+                break;
+            case spv::OpStore:
+                result.num_stores++;
+                break;
+            default:
+                break;
+        }
+        result.class_counts[GetOpcodeClass(opcode)]++;
+        result.num_instructions++;
+        offset += length;
+    }
+
+    if (!found_function)
+    {
+        result.first_function_index       = result.num_instructions;
+        result.first_function_word_offset = num_words;
+    }
+    return result;
+}
+
+bool SpirVScanner::HasCapability(const uint32_t* spirv_code, size_t spirv_num_bytes, uint32_t capability)
+{
+    const size_t num_words = spirv_num_bytes / sizeof(uint32_t);
+    if (spirv_code == nullptr || num_words < kHeaderSize)
+    {
+        return false;
+    }
+
+    // capabilities are always the first instructions of a module
+    size_t offset = kHeaderSize;
+    while (offset < num_words)
+    {
+        const uint32_t length = spirv_code[offset] >> 16;
+        if ((spirv_code[offset] & 0x0ffffu) != spv::OpCapability || length < 2 || length > num_words - offset)
+        {
+            return false;
+        }
+        if (spirv_code[offset + 1] == capability)
+        {
+            return true;
+        }
+        offset += length;
+    }
+    return false;
+}
+
+size_t SpirVScanner::CountOpcode(const uint32_t* opcodes, size_t count, uint32_t opcode)
+{
+#ifdef SPIRV_SCANNER_USE_X86_SIMD
+    switch (GetCachedSimdLevel())
+    {
+        case SimdLevel::AVX2:
+            return CountOpcodeAvx2(opcodes, count, opcode);
+        case SimdLevel::SSE42:
+            return CountOpcodeSse42(opcodes, count, opcode);
+        case SimdLevel::SCALAR:
+            break;
+    }
+#endif
+    return CountOpcodeScalar(opcodes, count, opcode);
+}
+
+size_t SpirVScanner::FindOpcode(const uint32_t* opcodes, size_t count, uint32_t opcode, size_t start)
+{
+    if (start >= count)
+    {
+        return count;
+    }
+
+    opcodes += start;
+    count -= start;
+#ifdef SPIRV_SCANNER_USE_X86_SIMD
+    switch (GetCachedSimdLevel())
+    {
+        case SimdLevel::AVX2:
+            return start + FindOpcodeAvx2(opcodes, count, opcode);
+        case SimdLevel::SSE42:
+            return start + FindOpcodeSse42(opcodes, count, opcode);
+        case SimdLevel::SCALAR:
+            break;
+    }
+#endif
+    return start + FindOpcodeScalar(opcodes, count, opcode);
+}
+
+const char* SpirVScanner::GetSimdLevel()
+{
+    switch (GetCachedSimdLevel())
+    {
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::SSE42:
+            return "sse4.2";
+        case SimdLevel::SCALAR:
+            break;
+    }
+    return "scalar";
+}
@@ -0,0 +1,111 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_SCANNER_H
+#define SPIRV_PARSING_COMMON_SPIRV_SCANNER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// SpirVScanner is a cheap prepass over a SPIR-V binary and a set of vectorized opcode searches.
+//
+// Scan() only reads the first word of every instruction: it validates the lengths, counts the instructions per
+// opcode class (and the few opcodes analyzers size their tables by) and locates the first OpFunction, without
+// decoding operands or allocating. Finding the instruction boundaries is a serial walk (each length is in the
+// previous instruction's first word), so it stays scalar.
+//
+// CountOpcode()/FindOpcode() work on a contiguous opcode column (see SpirVInstructionTable::opcodes()) and use
+// AVX2 or SSE4.2 when the CPU supports them, picked at runtime, with a scalar fallback.
+class SpirVScanner
+{
+  public:
+    enum class Status
+    {
+        SUCCESS = 0,
+
+        //! the binary is too small to hold the 5 word header
+        TOO_SMALL,
+
+        //! an instruction has a zero length or runs past the end of the binary
+        INVALID_INSTRUCTION_LENGTH
+    };
+
+    //! the logical sections of a module the instructions are counted in
+    enum OpcodeClass : uint32_t
+    {
+        CAPABILITY = 0,  // OpCapability
+        DEBUG,           // OpSource*, OpName, OpMemberName, OpString, OpLine, ...
+        ANNOTATION,      // OpDecorate, OpMemberDecorate, ...
+        TYPE,            // OpType*
+        CONSTANT,        // OpConstant*, OpSpecConstant*
+        VARIABLE,        // OpVariable
+        MEMORY,          // OpLoad, OpStore, OpCopy*, OpAccessChain, ...
+        FUNCTION,        // OpFunction, OpFunctionParameter, OpFunctionEnd, OpFunctionCall
+        OTHER,
+        OPCODE_CLASS_COUNT
+    };
+
+    struct Result
+    {
+        Status status = Status::SUCCESS;
+
+        uint32_t id_bound         = 0;
+        size_t   num_instructions = 0;
+
+        //! instruction index and word offset of the first OpFunction, num_instructions/num_words if there is none.
+        //! Everything before it is the module's metadata (capabilities, names, decorations, types, globals)
+        size_t first_function_index       = 0;
+        size_t first_function_word_offset = 0;
+
+        //! OpName, OpMemberName and OpStore instructions, OpVariable is its own class
+        size_t num_names        = 0;
+        size_t num_member_names = 0;
+        size_t num_stores       = 0;
+
+        std::array<size_t, OPCODE_CLASS_COUNT> class_counts{};
+
+        [[nodiscard]] size_t count(OpcodeClass opcode_class) const { return class_counts[opcode_class]; }
+    };
+
+    //! spirv-header is 5 d-words
+    static constexpr uint32_t kHeaderSize = 5;
+
+    static Result Scan(const uint32_t* spirv_code, size_t spirv_num_bytes);
+
+    [[nodiscard]] static OpcodeClass GetOpcodeClass(uint32_t opcode);
+
+    //! true if the module declares 'capability'. Only the OpCapability instructions at the start of the module are
+    //! read and nothing is allocated, so it is cheap enough to triage modules before parsing them
+    static bool HasCapability(const uint32_t* spirv_code, size_t spirv_num_bytes, uint32_t capability);
+
+    //! number of entries in 'opcodes' equal to 'opcode'
+    static size_t CountOpcode(const uint32_t* opcodes, size_t count, uint32_t opcode);
+
+    //! index of the first entry at or after 'start' equal to 'opcode', 'count' if there is none
+    static size_t FindOpcode(const uint32_t* opcodes, size_t count, uint32_t opcode, size_t start = 0);
+
+    //! name of the instruction set CountOpcode()/FindOpcode() use on this CPU ("avx2", "sse4.2" or "scalar")
+    static const char* GetSimdLevel();
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_SCANNER_H
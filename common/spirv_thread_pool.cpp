@@ -0,0 +1,170 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "spirv_thread_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace
+{
+
+// one per worker, holding (rank, task) pairs where the rank is the position in the order. Ranks only grow towards
+// the back, so the front is the queue's earliest task in the order (with a largest-first order, its largest)
+struct WorkQueue
+{
+    static constexpr size_t kEmpty = SIZE_MAX;
+
+    std::mutex                            mutex;
+    std::deque<std::pair<size_t, size_t>> tasks;
+
+    bool PopFront(size_t& task)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty())
+        {
+            return false;
+        }
+        task = tasks.front().second;
+        tasks.pop_front();
+        return true;
+    }
+
+    // rank of the front task, kEmpty if there is none
+    size_t FrontRank()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tasks.empty() ? kEmpty : tasks.front().first;
+    }
+};
+
+} // namespace
+
+SpirVThreadPool::SpirVThreadPool(size_t num_workers) : num_workers_(num_workers)
+{
+    if (num_workers_ == 0)
+    {
+        num_workers_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void SpirVThreadPool::Run(const std::vector<size_t>& order, const std::function<void(size_t, size_t)>& task) const
+{
+    // no point in starting threads that would never get a task
+    const size_t num_workers = std::min(num_workers_, order.size());
+    if (num_workers <= 1)
+    {
+        for (size_t task_index : order)
+        {
+            task(0, task_index);
+        }
+        return;
+    }
+
+    // tasks never get added once started, so a queue that is empty when every queue was checked stays empty
+    std::vector<std::unique_ptr<WorkQueue>> queues(num_workers);
+    for (auto& queue : queues)
+    {
+        queue = std::make_unique<WorkQueue>();
+    }
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        queues[i % num_workers]->tasks.emplace_back(i, order[i]);
+    }
+
+    // the first exception a task throws, rethrown once every worker is done. Later tasks still run
+    std::mutex         exception_mutex;
+    std::exception_ptr exception;
+
+    auto run_task = [&](size_t worker_index, size_t task_index) {
+        try
+        {
+            task(worker_index, task_index);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(exception_mutex);
+            if (!exception)
+            {
+                exception = std::current_exception();
+            }
+        }
+    };
+
+    auto worker = [&queues, &run_task, num_workers](size_t worker_index) {
+        size_t task_index = 0;
+        while (true)
+        {
+            if (queues[worker_index]->PopFront(task_index))
+            {
+                run_task(worker_index, task_index);
+                continue;
+            }
+
+            // steal the earliest front of all other queues. It can be taken by someone else in between, then
+            // the next front of that queue (or another queue on the next round) is taken instead
+            size_t victim    = num_workers;
+            size_t best_rank = WorkQueue::kEmpty;
+            for (size_t i = 1; i < num_workers; i++)
+            {
+                const size_t other = (worker_index + i) % num_workers;
+                const size_t rank  = queues[other]->FrontRank();
+                if (rank < best_rank)
+                {
+                    best_rank = rank;
+                    victim    = other;
+                }
+            }
+            if (victim == num_workers)
+            {
+                return;
+            }
+            if (queues[victim]->PopFront(task_index))
+            {
+                run_task(worker_index, task_index);
+            }
+        }
+    };
+
+    // the calling thread is worker 0
+    std::vector<std::thread> threads;
+    threads.reserve(num_workers - 1);
+    for (size_t i = 1; i < num_workers; i++)
+    {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
@@ -0,0 +1,55 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_COMMON_SPIRV_THREAD_POOL_H
+#define SPIRV_PARSING_COMMON_SPIRV_THREAD_POOL_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// SpirVThreadPool runs a batch of independent tasks (one per module) on a fixed number of workers.
+//
+// Tasks are dealt round-robin in the given order, so when the order is largest module first every worker starts on
+// one of the biggest modules. Each worker drains its own queue from the front and, once empty, steals the earliest
+// task in the order among the fronts of the other queues, so a worker that got unlucky with a few huge modules doesn't
+// hold up the others and the largest remaining modules still go first.
+//
+// A task that throws doesn't take the process down: the remaining tasks still run and Run() rethrows the first
+// exception once all are done. Callers that want to carry on report the failure inside the task instead.
+class SpirVThreadPool
+{
+  public:
+    //! 'num_workers' of 0 uses one worker per hardware thread
+    explicit SpirVThreadPool(size_t num_workers = 0);
+
+    [[nodiscard]] size_t num_workers() const { return num_workers_; }
+
+    //! call task(worker_index, task_index) once for every index in 'order', returns when all tasks are done
+    //! worker_index is below num_workers(), so callers can keep one analyzer per worker
+    void Run(const std::vector<size_t>& order, const std::function<void(size_t, size_t)>& task) const;
+
+  private:
+    size_t num_workers_ = 1;
+};
+
+#endif // SPIRV_PARSING_COMMON_SPIRV_THREAD_POOL_H
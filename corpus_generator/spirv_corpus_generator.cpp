@@ -0,0 +1,574 @@
+#include <iostream>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "spirv.hpp"
+#include "spirv_instruction.h"
+
+// Knobs of one synthetic module. Every module is a vertex shader so both examples have work to do:
+// - |num_functions| helpers are called from main, each one loads a buffer reference |num_stores| times into a
+//   function variable and then walks |access_chain_depth| links of the buffer reference chain.
+// - the chain is |bda_depth| nested buffer_reference structs, each one pointing to the next.
+// - |num_push_constants| pointers to the head of the chain live in the push constant block and
+//   |num_uniform_buffers| more as uint64 addresses in their own descriptors (each adds a handful of decorations).
+// - gl_Position is built from the components of |num_vertex_inputs| input locations.
+struct GeneratorOptions {
+    uint32_t num_functions = 4;
+    uint32_t num_stores = 4;
+    uint32_t num_uniform_buffers = 2;
+    uint32_t bda_depth = 3;
+    uint32_t num_push_constants = 2;
+    uint32_t access_chain_depth = 3;
+    uint32_t num_vertex_inputs = 2;
+    // when non-zero, helpers are added past |num_functions| until the module is at least this large
+    size_t target_size = 0;
+    uint32_t seed = 1;
+};
+
+class SpirVModuleWriter {
+  public:
+    uint32_t NewId() { return next_id_++; }
+    uint32_t id_bound() const { return next_id_; }
+
+    // Sections in the order the logical layout of a module requires
+    std::vector<uint32_t> preamble;
+    std::vector<uint32_t> debug;
+    std::vector<uint32_t> annotations;
+    std::vector<uint32_t> globals;
+    std::vector<uint32_t> functions;
+
+    static void Emit(std::vector<uint32_t>& section, spv::Op opcode, const std::vector<uint32_t>& operands,
+                     const char* literal = nullptr, const std::vector<uint32_t>& trailing = {}) {
+        std::vector<uint32_t> string_words;
+        if (literal) {
+            const std::string value = literal;
+            string_words.resize(value.size() / 4 + 1, 0);
+            for (size_t i = 0; i < value.size(); i++) {
+                string_words[i / 4] |= static_cast<uint32_t>(static_cast<uint8_t>(value[i])) << ((i % 4) * 8);
+            }
+        }
+        const uint32_t length = static_cast<uint32_t>(1 + operands.size() + string_words.size() + trailing.size());
+        section.push_back((length << 16) | static_cast<uint32_t>(opcode));
+        section.insert(section.end(), operands.begin(), operands.end());
+        section.insert(section.end(), string_words.begin(), string_words.end());
+        section.insert(section.end(), trailing.begin(), trailing.end());
+    }
+
+    void Name(uint32_t id, const std::string& name) { Emit(debug, spv::OpName, {id}, name.c_str()); }
+    void MemberName(uint32_t id, uint32_t member, const std::string& name) {
+        Emit(debug, spv::OpMemberName, {id, member}, name.c_str());
+    }
+    void Decorate(uint32_t id, spv::Decoration decoration, const std::vector<uint32_t>& literals = {}) {
+        std::vector<uint32_t> operands = {id, static_cast<uint32_t>(decoration)};
+        operands.insert(operands.end(), literals.begin(), literals.end());
+        Emit(annotations, spv::OpDecorate, operands);
+    }
+    void MemberDecorate(uint32_t id, uint32_t member, spv::Decoration decoration,
+                        const std::vector<uint32_t>& literals = {}) {
+        std::vector<uint32_t> operands = {id, member, static_cast<uint32_t>(decoration)};
+        operands.insert(operands.end(), literals.begin(), literals.end());
+        Emit(annotations, spv::OpMemberDecorate, operands);
+    }
+
+    size_t size_bytes() const {
+        return (kHeaderSize + preamble.size() + debug.size() + annotations.size() + globals.size() + functions.size()) *
+               sizeof(uint32_t);
+    }
+
+    std::vector<uint32_t> Finish() const {
+        // SPIR-V 1.3, the buffer reference support comes from SPV_KHR_physical_storage_buffer
+        std::vector<uint32_t> words = {spv::MagicNumber, 0x00010300, 0, next_id_, 0};
+        for (const std::vector<uint32_t>* section : {&preamble, &debug, &annotations, &globals, &functions}) {
+            words.insert(words.end(), section->begin(), section->end());
+        }
+        return words;
+    }
+
+  private:
+    static constexpr size_t kHeaderSize = 5;
+    uint32_t next_id_ = 1;
+};
+
+std::vector<uint32_t> GenerateModule(const GeneratorOptions& options) {
+    // mt19937 output is fully specified by the standard, the distributions are not, so only raw values are used
+    std::mt19937 random(options.seed);
+    const uint32_t bda_depth = std::max(1u, options.bda_depth);
+    const uint32_t num_push_constants = std::max(1u, options.num_push_constants);
+    const uint32_t access_chain_depth = std::min(options.access_chain_depth, bda_depth - 1);
+    const uint32_t num_vertex_inputs = std::max(1u, options.num_vertex_inputs);
+
+    SpirVModuleWriter writer;
+    using W = SpirVModuleWriter;
+    std::vector<uint32_t>& types = writer.globals;
+
+    W::Emit(writer.preamble, spv::OpCapability, {spv::CapabilityShader});
+    W::Emit(writer.preamble, spv::OpCapability, {spv::CapabilityInt64});
+    W::Emit(writer.preamble, spv::OpCapability, {spv::CapabilityPhysicalStorageBufferAddresses});
+    W::Emit(writer.preamble, spv::OpExtension, {}, "SPV_KHR_physical_storage_buffer");
+    W::Emit(writer.preamble, spv::OpMemoryModel,
+            {spv::AddressingModelPhysicalStorageBuffer64, spv::MemoryModelGLSL450});
+
+    const uint32_t void_type = writer.NewId();
+    const uint32_t void_function_type = writer.NewId();
+    const uint32_t float_type = writer.NewId();
+    const uint32_t float_function_type = writer.NewId();
+    const uint32_t int_type = writer.NewId();
+    const uint32_t uint64_type = writer.NewId();
+    const uint32_t vec4_type = writer.NewId();
+    W::Emit(types, spv::OpTypeVoid, {void_type});
+    W::Emit(types, spv::OpTypeFunction, {void_function_type, void_type});
+    W::Emit(types, spv::OpTypeFloat, {float_type, 32});
+    W::Emit(types, spv::OpTypeFunction, {float_function_type, float_type});
+    W::Emit(types, spv::OpTypeInt, {int_type, 32, 1});
+    W::Emit(types, spv::OpTypeInt, {uint64_type, 64, 0});
+    W::Emit(types, spv::OpTypeVector, {vec4_type, float_type, 4});
+
+    std::vector<uint32_t> int_constants;
+    const uint32_t num_int_constants = std::max({2u, num_push_constants, options.num_uniform_buffers});
+    for (uint32_t i = 0; i < num_int_constants; i++) {
+        int_constants.push_back(writer.NewId());
+        W::Emit(types, spv::OpConstant, {int_type, int_constants.back(), i});
+    }
+
+    // The chain is declared from the tail so every pointer type exists before the struct using it
+    std::vector<uint32_t> node_structs(bda_depth);
+    std::vector<uint32_t> node_pointers(bda_depth);
+    std::vector<uint32_t> next_member_pointers(bda_depth, 0);
+    for (uint32_t depth = bda_depth; depth-- > 0;) {
+        const bool has_next = depth + 1 < bda_depth;
+        node_structs[depth] = writer.NewId();
+        if (has_next) {
+            W::Emit(types, spv::OpTypeStruct, {node_structs[depth], node_pointers[depth + 1], float_type});
+            writer.MemberName(node_structs[depth], 0, "next");
+            writer.MemberName(node_structs[depth], 1, "value");
+            writer.MemberDecorate(node_structs[depth], 0, spv::DecorationOffset, {0});
+            writer.MemberDecorate(node_structs[depth], 1, spv::DecorationOffset, {8});
+            next_member_pointers[depth] = writer.NewId();
+        } else {
+            W::Emit(types, spv::OpTypeStruct, {node_structs[depth], float_type});
+            writer.MemberName(node_structs[depth], 0, "value");
+            writer.MemberDecorate(node_structs[depth], 0, spv::DecorationOffset, {0});
+        }
+        writer.Name(node_structs[depth], "Node" + std::to_string(depth));
+        writer.Decorate(node_structs[depth], spv::DecorationBlock);
+        node_pointers[depth] = writer.NewId();
+        W::Emit(types, spv::OpTypePointer,
+                {node_pointers[depth], spv::StorageClassPhysicalStorageBuffer, node_structs[depth]});
+        if (has_next) {
+            W::Emit(types, spv::OpTypePointer,
+                    {next_member_pointers[depth], spv::StorageClassPhysicalStorageBuffer, node_pointers[depth + 1]});
+        }
+    }
+    const uint32_t float_buffer_pointer = writer.NewId();
+    W::Emit(types, spv::OpTypePointer, {float_buffer_pointer, spv::StorageClassPhysicalStorageBuffer, float_type});
+
+    const uint32_t push_constant_struct = writer.NewId();
+    {
+        std::vector<uint32_t> operands = {push_constant_struct};
+        for (uint32_t i = 0; i < num_push_constants; i++) {
+            operands.push_back(node_pointers[0]);
+            writer.MemberName(push_constant_struct, i, "head" + std::to_string(i));
+            writer.MemberDecorate(push_constant_struct, i, spv::DecorationOffset, {i * 8});
+        }
+        W::Emit(types, spv::OpTypeStruct, operands);
+        writer.Name(push_constant_struct, "PushConstants");
+        writer.Decorate(push_constant_struct, spv::DecorationBlock);
+    }
+    const uint32_t push_constant_struct_pointer = writer.NewId();
+    const uint32_t push_constant_member_pointer = writer.NewId();
+    const uint32_t push_constants = writer.NewId();
+    W::Emit(types, spv::OpTypePointer,
+            {push_constant_struct_pointer, spv::StorageClassPushConstant, push_constant_struct});
+    W::Emit(types, spv::OpTypePointer, {push_constant_member_pointer, spv::StorageClassPushConstant, node_pointers[0]});
+    W::Emit(types, spv::OpVariable, {push_constant_struct_pointer, push_constants, spv::StorageClassPushConstant});
+    writer.Name(push_constants, "pc");
+
+    std::vector<uint32_t> uniform_buffers;
+    uint32_t uniform_address_pointer = 0;
+    if (options.num_uniform_buffers > 0) {
+        const uint32_t uniform_struct = writer.NewId();
+        const uint32_t uniform_struct_pointer = writer.NewId();
+        uniform_address_pointer = writer.NewId();
+        W::Emit(types, spv::OpTypeStruct, {uniform_struct, uint64_type});
+        W::Emit(types, spv::OpTypePointer, {uniform_struct_pointer, spv::StorageClassUniform, uniform_struct});
+        W::Emit(types, spv::OpTypePointer, {uniform_address_pointer, spv::StorageClassUniform, uint64_type});
+        writer.Name(uniform_struct, "Addresses");
+        writer.MemberName(uniform_struct, 0, "address");
+        writer.MemberDecorate(uniform_struct, 0, spv::DecorationOffset, {0});
+        writer.Decorate(uniform_struct, spv::DecorationBlock);
+        for (uint32_t i = 0; i < options.num_uniform_buffers; i++) {
+            uniform_buffers.push_back(writer.NewId());
+            W::Emit(types, spv::OpVariable, {uniform_struct_pointer, uniform_buffers.back(), spv::StorageClassUniform});
+            writer.Name(uniform_buffers.back(), "addresses" + std::to_string(i));
+            writer.Decorate(uniform_buffers.back(), spv::DecorationDescriptorSet, {i / 8});
+            writer.Decorate(uniform_buffers.back(), spv::DecorationBinding, {i % 8});
+        }
+    }
+
+    const uint32_t function_node_pointer = writer.NewId();
+    const uint32_t function_float_pointer = writer.NewId();
+    W::Emit(types, spv::OpTypePointer, {function_node_pointer, spv::StorageClassFunction, node_pointers[0]});
+    W::Emit(types, spv::OpTypePointer, {function_float_pointer, spv::StorageClassFunction, float_type});
+
+    // Vertex interface
+    const uint32_t per_vertex_struct = writer.NewId();
+    const uint32_t per_vertex_pointer = writer.NewId();
+    const uint32_t per_vertex = writer.NewId();
+    const uint32_t output_vec4_pointer = writer.NewId();
+    const uint32_t input_vec4_pointer = writer.NewId();
+    const uint32_t output_float_pointer = writer.NewId();
+    const uint32_t output_value = writer.NewId();
+    W::Emit(types, spv::OpTypeStruct, {per_vertex_struct, vec4_type});
+    W::Emit(types, spv::OpTypePointer, {per_vertex_pointer, spv::StorageClassOutput, per_vertex_struct});
+    W::Emit(types, spv::OpVariable, {per_vertex_pointer, per_vertex, spv::StorageClassOutput});
+    W::Emit(types, spv::OpTypePointer, {output_vec4_pointer, spv::StorageClassOutput, vec4_type});
+    W::Emit(types, spv::OpTypePointer, {input_vec4_pointer, spv::StorageClassInput, vec4_type});
+    W::Emit(types, spv::OpTypePointer, {output_float_pointer, spv::StorageClassOutput, float_type});
+    W::Emit(types, spv::OpVariable, {output_float_pointer, output_value, spv::StorageClassOutput});
+    writer.Name(per_vertex_struct, "gl_PerVertex");
+    writer.MemberName(per_vertex_struct, 0, "gl_Position");
+    writer.MemberDecorate(per_vertex_struct, 0, spv::DecorationBuiltIn, {spv::BuiltInPosition});
+    writer.Decorate(per_vertex_struct, spv::DecorationBlock);
+    writer.Name(output_value, "outValue");
+    writer.Decorate(output_value, spv::DecorationLocation, {0});
+
+    std::vector<uint32_t> vertex_inputs;
+    for (uint32_t i = 0; i < num_vertex_inputs; i++) {
+        vertex_inputs.push_back(writer.NewId());
+        W::Emit(types, spv::OpVariable, {input_vec4_pointer, vertex_inputs.back(), spv::StorageClassInput});
+        writer.Name(vertex_inputs.back(), "inAttribute" + std::to_string(i));
+        writer.Decorate(vertex_inputs.back(), spv::DecorationLocation, {i});
+    }
+
+    const uint32_t main_function = writer.NewId();
+    writer.Name(main_function, "main");
+    {
+        std::vector<uint32_t> interface = {per_vertex, output_value};
+        interface.insert(interface.end(), vertex_inputs.begin(), vertex_inputs.end());
+        W::Emit(writer.preamble, spv::OpEntryPoint, {spv::ExecutionModelVertex, main_function}, "main", interface);
+    }
+
+    const uint32_t memory_aligned = spv::MemoryAccessAlignedMask;
+    std::vector<uint32_t>& code = writer.functions;
+    std::vector<uint32_t> helpers;
+    // upper bound of the IDs one helper takes, including its call and add in main
+    const size_t ids_per_helper = 10 + 3 * std::max(1u, options.num_stores) + 2 * access_chain_depth + num_push_constants;
+    // main's own IDs for the vertex inputs and gl_Position
+    const size_t ids_reserved = 2 + 2 * 4 + num_vertex_inputs + 2;
+    bool reached_id_bound = false;
+    while (helpers.size() < options.num_functions ||
+           (options.target_size > 0 && writer.size_bytes() < options.target_size)) {
+        // the calls of the helpers so far are only emitted with main
+        const size_t ids_pending = 2 * helpers.size() + ids_reserved;
+        if (writer.id_bound() + ids_per_helper + ids_pending > SpirVInstructionTable::kMaxIdBound) {
+            reached_id_bound = true;
+            break;
+        }
+        const uint32_t helper = writer.NewId();
+        helpers.push_back(helper);
+        writer.Name(helper, "helper" + std::to_string(helpers.size() - 1));
+        W::Emit(code, spv::OpFunction, {float_type, helper, spv::FunctionControlMaskNone, float_function_type});
+        W::Emit(code, spv::OpLabel, {writer.NewId()});
+
+        // variables have to come first in the entry block
+        const uint32_t head = writer.NewId();
+        const uint32_t accumulator = writer.NewId();
+        W::Emit(code, spv::OpVariable, {function_node_pointer, head, spv::StorageClassFunction});
+        W::Emit(code, spv::OpVariable, {function_float_pointer, accumulator, spv::StorageClassFunction});
+        writer.Decorate(head, spv::DecorationRestrictPointer);
+
+        // like a compiler would, each push constant member is only addressed once per function
+        std::vector<uint32_t> member_pointers(num_push_constants, 0);
+        for (uint32_t store = 0; store < std::max(1u, options.num_stores); store++) {
+            const uint32_t source = static_cast<uint32_t>(random());
+            const uint32_t pointer = writer.NewId();
+            if (!uniform_buffers.empty() && (source & 1)) {
+                const uint32_t address_pointer = writer.NewId();
+                const uint32_t address = writer.NewId();
+                W::Emit(code, spv::OpAccessChain,
+                        {uniform_address_pointer, address_pointer,
+                         uniform_buffers[(source >> 1) % uniform_buffers.size()], int_constants[0]});
+                W::Emit(code, spv::OpLoad, {uint64_type, address, address_pointer});
+                W::Emit(code, spv::OpConvertUToPtr, {node_pointers[0], pointer, address});
+            } else {
+                const uint32_t member = (source >> 1) % num_push_constants;
+                if (member_pointers[member] == 0) {
+                    member_pointers[member] = writer.NewId();
+                    W::Emit(code, spv::OpAccessChain,
+                            {push_constant_member_pointer, member_pointers[member], push_constants,
+                             int_constants[member]});
+                }
+                W::Emit(code, spv::OpLoad, {node_pointers[0], pointer, member_pointers[member]});
+            }
+            W::Emit(code, spv::OpStore, {head, pointer});
+        }
+
+        uint32_t node = writer.NewId();
+        W::Emit(code, spv::OpLoad, {node_pointers[0], node, head});
+        for (uint32_t depth = 0; depth < access_chain_depth; depth++) {
+            const uint32_t next_pointer = writer.NewId();
+            const uint32_t next = writer.NewId();
+            W::Emit(code, spv::OpAccessChain, {next_member_pointers[depth], next_pointer, node, int_constants[0]});
+            W::Emit(code, spv::OpLoad, {node_pointers[depth + 1], next, next_pointer, memory_aligned, 8});
+            node = next;
+        }
+        const bool has_next = access_chain_depth + 1 < bda_depth;
+        const uint32_t value_pointer = writer.NewId();
+        const uint32_t value = writer.NewId();
+        const uint32_t result = writer.NewId();
+        W::Emit(code, spv::OpAccessChain,
+                {float_buffer_pointer, value_pointer, node, int_constants[has_next ? 1 : 0]});
+        W::Emit(code, spv::OpLoad, {float_type, value, value_pointer, memory_aligned, 4});
+        W::Emit(code, spv::OpStore, {accumulator, value});
+        W::Emit(code, spv::OpLoad, {float_type, result, accumulator});
+        W::Emit(code, spv::OpReturnValue, {result});
+        W::Emit(code, spv::OpFunctionEnd, {});
+    }
+
+    W::Emit(code, spv::OpFunction, {void_type, main_function, spv::FunctionControlMaskNone, void_function_type});
+    W::Emit(code, spv::OpLabel, {writer.NewId()});
+    uint32_t sum = 0;
+    for (uint32_t helper : helpers) {
+        const uint32_t call = writer.NewId();
+        W::Emit(code, spv::OpFunctionCall, {float_type, call, helper});
+        if (sum == 0) {
+            sum = call;
+        } else {
+            const uint32_t add = writer.NewId();
+            W::Emit(code, spv::OpFAdd, {float_type, add, sum, call});
+            sum = add;
+        }
+    }
+    if (sum != 0) {
+        W::Emit(code, spv::OpStore, {output_value, sum});
+    }
+
+    // each component of gl_Position comes from one of the inputs, round robin
+    std::vector<uint32_t> input_loads(num_vertex_inputs, 0);
+    std::vector<uint32_t> position_operands = {vec4_type, 0};
+    for (uint32_t component = 0; component < 4; component++) {
+        const uint32_t input = component % num_vertex_inputs;
+        if (input_loads[input] == 0) {
+            input_loads[input] = writer.NewId();
+            W::Emit(code, spv::OpLoad, {vec4_type, input_loads[input], vertex_inputs[input]});
+        }
+        const uint32_t extract = writer.NewId();
+        W::Emit(code, spv::OpCompositeExtract, {float_type, extract, input_loads[input], component});
+        position_operands.push_back(extract);
+    }
+    position_operands[1] = writer.NewId();
+    const uint32_t position_pointer = writer.NewId();
+    W::Emit(code, spv::OpCompositeConstruct, position_operands);
+    W::Emit(code, spv::OpAccessChain, {output_vec4_pointer, position_pointer, per_vertex, int_constants[0]});
+    W::Emit(code, spv::OpStore, {position_pointer, position_operands[1]});
+    W::Emit(code, spv::OpReturn, {});
+    W::Emit(code, spv::OpFunctionEnd, {});
+
+    if (reached_id_bound) {
+        std::cout << "WARNING: stopped at " << writer.size_bytes() << " bytes, the next helper would exceed the "
+                  << "maximum ID bound (more --stores per function packs more bytes per ID)\n";
+    }
+    return writer.Finish();
+}
+
+bool WriteModule(const std::string& path, const std::vector<uint32_t>& words) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool written = fwrite(words.data(), sizeof(uint32_t), words.size(), file) == words.size();
+    return fclose(file) == 0 && written;
+}
+
+// a whole decimal number that fits a uint32_t, false for anything else (signs, trailing characters, overflow)
+bool ParseUInt32(const char* text, uint32_t& value) {
+    if (text[0] < '0' || text[0] > '9') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno == ERANGE || *end != '\0' || parsed > UINT32_MAX) {
+        return false;
+    }
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+// plain bytes or a K/M/G suffix, false for anything else or a size that doesn't fit
+bool ParseSize(const char* text, size_t& size) {
+    if (text[0] < '0' || text[0] > '9') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno == ERANGE || parsed > SIZE_MAX) {
+        return false;
+    }
+
+    size_t shift = 0;
+    switch (*end) {
+        case '\0':
+            break;
+        case 'k':
+        case 'K':
+            shift = 10;
+            break;
+        case 'm':
+        case 'M':
+            shift = 20;
+            break;
+        case 'g':
+        case 'G':
+            shift = 30;
+            break;
+        default:
+            return false;
+    }
+    if ((shift > 0 && end[1] != '\0') || parsed > (SIZE_MAX >> shift)) {
+        return false;
+    }
+    size = static_cast<size_t>(parsed) << shift;
+    return true;
+}
+
+void PrintUsage(const char* program) {
+    std::cout << "Usage:\n\t" << program
+              << " [--functions N] [--stores N] [--uniform-buffers N] [--bda-depth N] [--push-constants N]\n"
+                 "\t\t[--access-chain-depth N] [--vertex-inputs N] [--target-size SIZE] [--min-size SIZE]\n"
+                 "\t\t[--seed N] [--count N] (output.spv | output_directory)\n"
+                 "\tSIZE takes a K, M or G suffix. With --count > 1 the output is a directory.\n";
+}
+
+int main(int argc, char** argv) {
+    GeneratorOptions options;
+    std::string output_path;
+    uint32_t count = 1;
+    // sweep: |count| modules with target sizes growing geometrically from --min-size to --target-size
+    size_t min_size = 0;
+
+    const std::pair<const char*, uint32_t*> number_options[] = {
+        {"--functions", &options.num_functions},
+        {"--stores", &options.num_stores},
+        {"--uniform-buffers", &options.num_uniform_buffers},
+        {"--bda-depth", &options.bda_depth},
+        {"--push-constants", &options.num_push_constants},
+        {"--access-chain-depth", &options.access_chain_depth},
+        {"--vertex-inputs", &options.num_vertex_inputs},
+        {"--seed", &options.seed},
+        {"--count", &count},
+    };
+    const std::pair<const char*, size_t*> size_options[] = {
+        {"--target-size", &options.target_size},
+        {"--min-size", &min_size},
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg.empty() || arg[0] != '-') {
+            if (!output_path.empty()) {
+                std::cout << "ERROR: unexpected argument " << arg << "\n";
+                PrintUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            output_path = arg;
+            continue;
+        }
+
+        // every option takes a value, anything else starting with '-' is a mistake rather than an output path
+        bool known = false;
+        bool valid = false;
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        for (const auto& [name, target] : number_options) {
+            if (arg == name) {
+                known = true;
+                valid = value && ParseUInt32(value, *target);
+            }
+        }
+        for (const auto& [name, target] : size_options) {
+            if (arg == name) {
+                known = true;
+                valid = value && ParseSize(value, *target);
+            }
+        }
+        if (!known) {
+            std::cout << "ERROR: unknown option " << arg << "\n";
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        if (!valid) {
+            if (value) {
+                std::cout << "ERROR: invalid value " << value << " for " << arg << "\n";
+            } else {
+                std::cout << "ERROR: missing value for " << arg << "\n";
+            }
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        i++;
+    }
+
+    if (count == 0) {
+        std::cout << "ERROR: --count must be at least 1\n";
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (output_path.empty()) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (count == 1) {
+        const std::vector<uint32_t> words = GenerateModule(options);
+        if (!WriteModule(output_path, words)) {
+            std::cout << "ERROR: Unable to write " << output_path << "\n";
+            return EXIT_FAILURE;
+        }
+        std::cout << output_path << ": " << words.size() * sizeof(uint32_t) << " bytes\n";
+        return EXIT_SUCCESS;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(output_path, error);
+    if (error) {
+        std::cout << "ERROR: Unable to create " << output_path << "\n";
+        return EXIT_FAILURE;
+    }
+    const size_t max_size = options.target_size;
+    if (min_size == 0 || min_size > max_size) {
+        min_size = max_size;
+    }
+    size_t total_bytes = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        GeneratorOptions module_options = options;
+        module_options.seed = options.seed + i;
+        if (max_size > 0) {
+            const double t = static_cast<double>(i) / static_cast<double>(count - 1);
+            const double ratio = static_cast<double>(max_size) / static_cast<double>(min_size);
+            module_options.target_size = static_cast<size_t>(static_cast<double>(min_size) * std::pow(ratio, t));
+        }
+        const std::vector<uint32_t> words = GenerateModule(module_options);
+        char name[32];
+        snprintf(name, sizeof(name), "synthetic_%04u.spv", i);
+        const std::string path = (std::filesystem::path(output_path) / name).string();
+        if (!WriteModule(path, words)) {
+            std::cout << "ERROR: Unable to write " << path << "\n";
+            return EXIT_FAILURE;
+        }
+        total_bytes += words.size() * sizeof(uint32_t);
+    }
+    std::cout << "Wrote " << count << " modules (" << total_bytes << " bytes) to " << output_path << "\n";
+    return EXIT_SUCCESS;
+}
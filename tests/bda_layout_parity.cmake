@@ -0,0 +1,67 @@
+# Runs bda_address with the native struct layouts and with the SPIRV-Reflect ones (--reflect) over modules from
+# spirv_corpus_generator and fails unless both report the same buffer-references.
+#
+#   cmake -DGENERATOR=... -DBDA_ADDRESS=... -DWORK_DIRECTORY=... -P bda_layout_parity.cmake
+
+foreach(variable GENERATOR BDA_ADDRESS WORK_DIRECTORY)
+    if(NOT DEFINED ${variable})
+        message(FATAL_ERROR "${variable} is not set")
+    endif()
+endforeach()
+
+file(REMOVE_RECURSE "${WORK_DIRECTORY}")
+file(MAKE_DIRECTORY "${WORK_DIRECTORY}")
+
+function(run_checked)
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE result OUTPUT_VARIABLE output ERROR_VARIABLE output)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "'${ARGN}' failed (${result}):\n${output}")
+    endif()
+endfunction()
+
+function(compare_layouts name native reflect)
+    execute_process(COMMAND "${CMAKE_COMMAND}" -E compare_files "${native}" "${reflect}" RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${name}: the native and reflect layouts differ, see ${native} and ${reflect}")
+    endif()
+endfunction()
+
+# a sweep of module sizes and shapes, compared record by record as NDJSON
+set(sweep "${WORK_DIRECTORY}/sweep")
+run_checked("${GENERATOR}" --count 8 --min-size 4K --target-size 64K --uniform-buffers 3 --bda-depth 4
+            --access-chain-depth 4 --push-constants 3 --seed 7 "${sweep}")
+foreach(layout native reflect)
+    set(layout_flag "")
+    if(layout STREQUAL "reflect")
+        set(layout_flag --reflect)
+    endif()
+    execute_process(COMMAND "${BDA_ADDRESS}" ${layout_flag} --ndjson --jobs 2 "${sweep}"
+                    RESULT_VARIABLE result OUTPUT_FILE "${WORK_DIRECTORY}/sweep_${layout}.ndjson"
+                    ERROR_VARIABLE errors)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "bda_address ${layout_flag} failed on ${sweep} (${result}):\n${errors}")
+    endif()
+endforeach()
+compare_layouts(sweep "${WORK_DIRECTORY}/sweep_native.ndjson" "${WORK_DIRECTORY}/sweep_reflect.ndjson")
+# an empty run would match as well
+file(STRINGS "${WORK_DIRECTORY}/sweep_native.ndjson" references REGEX "\"type\":\"buffer-reference\"")
+list(LENGTH references num_references)
+if(num_references EQUAL 0)
+    message(FATAL_ERROR "sweep: no buffer-references found in ${sweep}")
+endif()
+
+# single modules through the flat result format, which also holds the struct offsets and strides bit for bit
+foreach(shape "1;1;1;0" "4;2;5;2" "2;6;3;4")
+    list(GET shape 0 uniform_buffers)
+    list(GET shape 1 bda_depth)
+    list(GET shape 2 access_chain_depth)
+    list(GET shape 3 push_constants)
+    set(name "module_${uniform_buffers}_${bda_depth}_${access_chain_depth}_${push_constants}")
+    run_checked("${GENERATOR}" --uniform-buffers ${uniform_buffers} --bda-depth ${bda_depth}
+                --access-chain-depth ${access_chain_depth} --push-constants ${push_constants} --target-size 16K
+                "${WORK_DIRECTORY}/${name}.spv")
+    run_checked("${BDA_ADDRESS}" --binary-output "${WORK_DIRECTORY}/${name}_native.spbr" "${WORK_DIRECTORY}/${name}.spv")
+    run_checked("${BDA_ADDRESS}" --reflect --binary-output "${WORK_DIRECTORY}/${name}_reflect.spbr"
+                "${WORK_DIRECTORY}/${name}.spv")
+    compare_layouts(${name} "${WORK_DIRECTORY}/${name}_native.spbr" "${WORK_DIRECTORY}/${name}_reflect.spbr")
+endforeach()
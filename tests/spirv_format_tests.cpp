@@ -0,0 +1,615 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "spirv_buffer_reference_file.h"
+#include "spirv_instruction.h"
+#include "spirv_ndjson_writer.h"
+#include "spirv_parsing_util.h"
+#include "spirv_result_cache.h"
+#include "spirv_result_ring.h"
+#include "spirv_thread_pool.h"
+#include "vertex_input_position_analyzer.h"
+
+// Checks of the formats other tools and processes rely on: the cache key hash, the flat buffer-reference file, the
+// NDJSON escaping and the result ring, plus the pass's handling of malformed input. Every failed check is printed,
+// the exit code says whether any failed.
+
+static int g_num_failures = 0;
+
+#define CHECK(condition)                                                                \
+    do {                                                                                \
+        if (!(condition)) {                                                             \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            g_num_failures++;                                                           \
+        }                                                                               \
+    } while (0)
+
+namespace {
+
+uint64_t HashString(const char* text, uint64_t seed = 0) {
+    return SpirVResultCache::Hash(text, strlen(text), seed);
+}
+
+// reference vectors of XXH64, covering the short input paths and the 32-byte stripes
+void TestHash() {
+    CHECK(HashString("") == 0xEF46DB3751D8E999ull);
+    CHECK(HashString("a") == 0xD24EC4F1A98C6E5Bull);
+    CHECK(HashString("abc") == 0x44BC2CF5AD770999ull);
+    CHECK(HashString("xxhash") == 0x32DD38952C4BC720ull);
+    CHECK(HashString("xxhash", 20141025) == 0xB559B98D844E0635ull);
+    CHECK(HashString("Nobody inspects the spammish repetition") == 0xFBCEA83C8A378BF1ull);
+}
+
+SpirVParsingUtil::BufferReferenceInfo MakeInfo(uint32_t set, uint32_t binding, uint32_t offset, uint32_t stride) {
+    SpirVParsingUtil::BufferReferenceInfo info;
+    info.source = SpirVParsingUtil::BufferReferenceLocation::STORAGE_BUFFER;
+    info.set = set;
+    info.binding = binding;
+    info.buffer_offset = offset;
+    info.array_stride = stride;
+    return info;
+}
+
+std::vector<uint8_t> WriteReferenceFile() {
+    SpirVBufferReferenceFileWriter writer;
+    writer.Add(MakeInfo(1, 4, 0, 8), {"geometryNodes", "nodes", "address"});
+    writer.Add(MakeInfo(2, 3, 16, 8), {"ptrs"});
+    // names are interned, the second "nodes" shares the first one's bytes
+    writer.Add(MakeInfo(0, 0, 24, 0), {"(PC)", "nodes"});
+    writer.Add(MakeInfo(3, 1, 32, 0), {});
+
+    std::vector<uint8_t> bytes;
+    writer.Finish(bytes);
+    return bytes;
+}
+
+// the file of WriteReferenceFile() with one value overwritten
+template <typename Value>
+std::vector<uint8_t> Corrupt(size_t offset, Value value) {
+    std::vector<uint8_t> bytes = WriteReferenceFile();
+    memcpy(bytes.data() + offset, &value, sizeof(value));
+    return bytes;
+}
+
+SpirVBufferReferenceFileHeader ReadHeader(const std::vector<uint8_t>& bytes) {
+    SpirVBufferReferenceFileHeader header;
+    memcpy(&header, bytes.data(), sizeof(header));
+    return header;
+}
+
+bool Opens(const std::vector<uint8_t>& bytes) {
+    SpirVBufferReferenceFileReader reader;
+    return reader.Open(bytes.data(), bytes.size());
+}
+
+void TestReferenceFileRoundTrip() {
+    const std::vector<uint8_t> bytes = WriteReferenceFile();
+    SpirVBufferReferenceFileReader reader;
+    CHECK(reader.Open(bytes.data(), bytes.size()));
+    CHECK(reader.size() == 4);
+    if (reader.size() != 4) {
+        return;
+    }
+
+    const SpirVParsingUtil::BufferReferenceInfo info = reader.GetInfo(1);
+    CHECK(info.source == SpirVParsingUtil::BufferReferenceLocation::STORAGE_BUFFER);
+    CHECK(info.set == 2 && info.binding == 3 && info.buffer_offset == 16 && info.array_stride == 8);
+
+    CHECK(reader.GetChainLength(0) == 3);
+    CHECK(strcmp(reader.GetChainName(0, 0), "geometryNodes") == 0);
+    CHECK(strcmp(reader.GetChainName(0, 2), "address") == 0);
+    CHECK(strcmp(reader.GetChainName(2, 0), "(PC)") == 0);
+    CHECK(reader.GetChainName(2, 1) == reader.GetChainName(0, 1));
+    CHECK(reader.GetChainLength(3) == 0);
+
+    // equal results give equal files, the padding is zeroed
+    CHECK(WriteReferenceFile() == bytes);
+
+    // a file is read in place from anywhere in a larger buffer, e.g. a cache entry behind its header
+    std::vector<uint8_t> entry(SpirVResultCache::kPayloadOffset, 0xCD);
+    entry.insert(entry.end(), bytes.begin(), bytes.end());
+    CHECK(reader.Open(entry.data() + SpirVResultCache::kPayloadOffset, bytes.size()));
+    CHECK(reader.size() == 4);
+}
+
+void TestReferenceFileRejectsDamage() {
+    const std::vector<uint8_t> bytes = WriteReferenceFile();
+    const SpirVBufferReferenceFileHeader header = ReadHeader(bytes);
+
+    CHECK(!Opens({}));
+    for (size_t size = 0; size < bytes.size(); size++) {
+        SpirVBufferReferenceFileReader reader;
+        CHECK(!reader.Open(bytes.data(), size));
+    }
+
+    CHECK(!Opens(Corrupt(offsetof(SpirVBufferReferenceFileHeader, magic), uint32_t(0))));
+    CHECK(!Opens(Corrupt(offsetof(SpirVBufferReferenceFileHeader, version), kSpirVBufferReferenceFileVersion + 1)));
+    CHECK(!Opens(Corrupt(offsetof(SpirVBufferReferenceFileHeader, record_bytes), uint32_t(16))));
+    CHECK(!Opens(Corrupt(offsetof(SpirVBufferReferenceFileHeader, total_bytes), header.total_bytes + 1)));
+    CHECK(!Opens(Corrupt(offsetof(SpirVBufferReferenceFileHeader, num_records), uint32_t(0x10000000))));
+    CHECK(!Opens(Corrupt(offsetof(SpirVBufferReferenceFileHeader, strings_offset), ~uint64_t(0))));
+    CHECK(!Opens(Corrupt(offsetof(SpirVBufferReferenceFileHeader, strings_bytes), header.strings_bytes + 1)));
+
+    // a chain entry pointing past the string table, a record past the chain, a name without its terminator
+    CHECK(!Opens(Corrupt(static_cast<size_t>(header.chain_offset), static_cast<uint32_t>(header.strings_bytes))));
+    CHECK(!Opens(Corrupt(static_cast<size_t>(header.records_offset) + offsetof(SpirVBufferReferenceRecord, chain_first),
+                         header.num_chain_entries)));
+    CHECK(!Opens(Corrupt(static_cast<size_t>(header.strings_offset + header.strings_bytes - 1), 'x')));
+}
+
+// everything 'write' produced, read back through a temporary file
+template <typename Write>
+std::string CaptureNdjson(size_t buffer_size, Write write) {
+    FILE* output = tmpfile();
+    if (!output) {
+        return {};
+    }
+    {
+        SpirVNdjsonWriter writer(output, buffer_size);
+        write(writer);
+    }
+
+    std::string text(static_cast<size_t>(ftell(output)), '\0');
+    rewind(output);
+    const size_t num_read = fread(&text[0], 1, text.size(), output);
+    fclose(output);
+    text.resize(num_read);
+    return text;
+}
+
+std::string WriteNdjson(size_t buffer_size, const char* key, const char* value) {
+    return CaptureNdjson(buffer_size, [&](SpirVNdjsonWriter& writer) {
+        writer.BeginObject();
+        writer.String(key, value);
+        writer.EndObject();
+    });
+}
+
+void TestNdjsonEscaping() {
+    CHECK(WriteNdjson(64, "file", "plain") == "{\"file\":\"plain\"}\n");
+    CHECK(WriteNdjson(64, "q\"k", "a\"b\\c") == "{\"q\\\"k\":\"a\\\"b\\\\c\"}\n");
+    CHECK(WriteNdjson(64, "k", "\n\t\r\x01\x1f\x7f") == "{\"k\":\"\\n\\t\\u000d\\u0001\\u001f\x7f\"}\n");
+    // UTF-8 passes through as is
+    CHECK(WriteNdjson(64, "k", "\xc3\xa9") == "{\"k\":\"\xc3\xa9\"}\n");
+    CHECK(WriteNdjson(64, "k", "\xf0\x9f\x98\x80") == "{\"k\":\"\xf0\x9f\x98\x80\"}\n");
+    // anything else becomes U+FFFD, one per byte that can't start a sequence: a stray continuation byte, a cut
+    // sequence, an overlong '/', a surrogate and a code point above U+10FFFF
+    CHECK(WriteNdjson(64, "k", "a\x80" "b") == "{\"k\":\"a\\ufffdb\"}\n");
+    CHECK(WriteNdjson(64, "k", "\xc3") == "{\"k\":\"\\ufffd\"}\n");
+    CHECK(WriteNdjson(64, "k", "\xc0\xaf") == "{\"k\":\"\\ufffd\\ufffd\"}\n");
+    CHECK(WriteNdjson(64, "k", "\xed\xa0\x80") == "{\"k\":\"\\ufffd\\ufffd\\ufffd\"}\n");
+    CHECK(WriteNdjson(64, "k", "\xf4\x90\x80\x80") == "{\"k\":\"\\ufffd\\ufffd\\ufffd\\ufffd\"}\n");
+
+    // escapes that straddle the buffer end, in a string far longer than the buffer
+    std::string value;
+    std::string expected = "{\"k\":\"";
+    for (int i = 0; i < 100; i++) {
+        value += "ab\"\x02";
+        expected += "ab\\\"\\u0002";
+    }
+    expected += "\"}\n";
+    CHECK(WriteNdjson(7, "k", value.c_str()) == expected);
+
+    // commas stay right at any depth, and the record still ends its line once every level is closed
+    const int depth = 40;
+    const std::string nested = CaptureNdjson(64, [&](SpirVNdjsonWriter& writer) {
+        writer.BeginObject();
+        for (int i = 0; i < depth; i++) {
+            writer.BeginArray("a");
+            writer.UInt(1);
+            writer.BeginObject();
+        }
+        for (int i = 0; i < depth; i++) {
+            writer.EndObject();
+            writer.UInt(2);
+            writer.EndArray();
+        }
+        writer.EndObject();
+        writer.BeginObject();
+        writer.EndObject();
+    });
+    std::string nested_expected = "{";
+    for (int i = 0; i < depth; i++) {
+        nested_expected += "\"a\":[1,{";
+    }
+    for (int i = 0; i < depth; i++) {
+        nested_expected += "},2]";
+    }
+    nested_expected += "}\n{}\n";
+    CHECK(nested == nested_expected);
+}
+
+void TestResultRing() {
+    // the capacity is rounded down to a power of two
+    uint32_t storage[5] = {};
+    SpirVResultRing<uint32_t> ring(storage, 5);
+    CHECK(ring.capacity() == 4);
+
+    uint32_t next_push = 0;
+    uint32_t next_pop = 0;
+    uint64_t num_rejected = 0;
+    uint32_t record = 0;
+
+    // push more than fits and pop less than was pushed, so head and tail wrap many times
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 3; i++) {
+            if (ring.TryPush(next_push)) {
+                next_push++;
+            } else {
+                num_rejected++;
+            }
+        }
+        CHECK(ring.size() <= ring.capacity());
+        for (int i = 0; i < 2 && ring.TryPop(record); i++) {
+            CHECK(record == next_pop);
+            next_pop++;
+        }
+    }
+    CHECK(num_rejected > 0);
+    CHECK(ring.dropped() == num_rejected);
+
+    // records come out in push order, a full ring keeps what it had
+    while (ring.TryPop(record)) {
+        CHECK(record == next_pop);
+        next_pop++;
+    }
+    CHECK(next_pop == next_push);
+    CHECK(ring.size() == 0);
+
+    SpirVResultRing<uint32_t> empty(nullptr, 0);
+    CHECK(empty.capacity() == 0);
+    CHECK(!empty.TryPush(1));
+    CHECK(!empty.TryPop(record));
+    CHECK(empty.dropped() == 1);
+}
+
+// a copy of 'words' that ends right before an inaccessible page, so reading one byte past it faults
+class GuardedModule {
+  public:
+    explicit GuardedModule(const std::vector<uint32_t>& words) {
+        const size_t num_bytes = words.size() * sizeof(uint32_t);
+#if defined(__unix__)
+        page_bytes_ = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        mapping_bytes_ = (num_bytes + page_bytes_ - 1) / page_bytes_ * page_bytes_ + page_bytes_;
+        void* mapping = mmap(nullptr, mapping_bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping != MAP_FAILED) {
+            mapping_ = static_cast<uint8_t*>(mapping);
+            mprotect(mapping_ + mapping_bytes_ - page_bytes_, page_bytes_, PROT_NONE);
+            uint8_t* end = mapping_ + mapping_bytes_ - page_bytes_;
+            memcpy(end - num_bytes, words.data(), num_bytes);
+            data_ = reinterpret_cast<const uint32_t*>(end - num_bytes);
+        }
+#else
+        fallback_ = words;
+        data_ = fallback_.data();
+#endif
+        num_bytes_ = data_ ? num_bytes : 0;
+    }
+
+    ~GuardedModule() {
+#if defined(__unix__)
+        if (mapping_) {
+            munmap(mapping_, mapping_bytes_);
+        }
+#endif
+    }
+
+    GuardedModule(const GuardedModule&) = delete;
+    GuardedModule& operator=(const GuardedModule&) = delete;
+
+    [[nodiscard]] const uint32_t* data() const { return data_; }
+    [[nodiscard]] size_t size_bytes() const { return num_bytes_; }
+
+  private:
+    const uint32_t* data_ = nullptr;
+    size_t num_bytes_ = 0;
+#if defined(__unix__)
+    uint8_t* mapping_ = nullptr;
+    size_t mapping_bytes_ = 0;
+    size_t page_bytes_ = 0;
+#else
+    std::vector<uint32_t> fallback_;
+#endif
+};
+
+uint32_t FirstWord(uint32_t length, spv::Op opcode) {
+    return (length << 16) | static_cast<uint32_t>(opcode);
+}
+
+// header and the capability that makes the BDA pass look at the rest of the module
+std::vector<uint32_t> ModuleUsingBufferDeviceAddress() {
+    return {spv::MagicNumber, 0x00010500, 0, 8, 0, FirstWord(2, spv::OpCapability),
+            spv::CapabilityPhysicalStorageBufferAddresses};
+}
+
+// up to four characters packed into a literal word, with the terminator only if it fits
+template <size_t N>
+uint32_t PackChars(const char (&text)[N]) {
+    static_assert(N <= sizeof(uint32_t) + 1, "one word only");
+    uint32_t word = 0;
+    memcpy(&word, text, std::min(N, sizeof(word)));
+    return word;
+}
+
+void TestUnterminatedNames() {
+    // "abc" ends inside its word, "abcd" would need another word for the terminator
+    std::vector<uint32_t> words = ModuleUsingBufferDeviceAddress();
+    words.insert(words.end(), {FirstWord(3, spv::OpName), 1, PackChars("abc")});
+    words.insert(words.end(), {FirstWord(3, spv::OpName), 2, PackChars("abcd")});
+    {
+        GuardedModule module(words);
+        SpirVInstructionTable instructions;
+        CHECK(instructions.Build(module.data(), module.size_bytes()) == SpirVInstructionTable::Status::SUCCESS);
+        CHECK(instructions.size() == 3);
+        if (instructions.size() == 3) {
+            CHECK(instructions[1].operand_string(1) && strcmp(instructions[1].operand_string(1), "abc") == 0);
+            CHECK(instructions[2].operand_string(1) == nullptr);
+            CHECK(instructions[2].operand_string(2) == nullptr);
+        }
+
+        SpirVParsingUtil parsing_util;
+        CHECK(parsing_util.FindBufferReferences(module.data(), module.size_bytes()));
+    }
+
+    // the same for OpMemberName, and names cut short before their operands, each as the last instruction
+    const std::vector<std::vector<uint32_t>> tails = {
+        {FirstWord(4, spv::OpMemberName), 3, 0, PackChars("abcd")},
+        {FirstWord(3, spv::OpMemberName), 3, 0},
+        {FirstWord(2, spv::OpName), 1},
+        {FirstWord(1, spv::OpName)},
+    };
+    for (const std::vector<uint32_t>& tail : tails) {
+        std::vector<uint32_t> module_words = ModuleUsingBufferDeviceAddress();
+        module_words.insert(module_words.end(), tail.begin(), tail.end());
+        GuardedModule module(module_words);
+        SpirVParsingUtil parsing_util;
+        CHECK(parsing_util.FindBufferReferences(module.data(), module.size_bytes()));
+    }
+}
+
+// a storage buffer at set 1, binding 4 whose member "ptr" is a buffer-reference, never dereferenced
+std::vector<uint32_t> ModuleWithBufferReference() {
+    std::vector<uint32_t> words = ModuleUsingBufferDeviceAddress();
+    words[3] = 7;
+    const std::vector<uint32_t> body = {
+        FirstWord(3, spv::OpMemoryModel), spv::AddressingModelPhysicalStorageBuffer64, spv::MemoryModelGLSL450,
+        FirstWord(4, spv::OpMemberName), 3, 0, PackChars("ptr"),
+        FirstWord(3, spv::OpDecorate), 3, spv::DecorationBlock,
+        FirstWord(5, spv::OpMemberDecorate), 3, 0, spv::DecorationOffset, 0,
+        FirstWord(5, spv::OpMemberDecorate), 2, 0, spv::DecorationOffset, 0,
+        FirstWord(4, spv::OpDecorate), 5, spv::DecorationDescriptorSet, 1,
+        FirstWord(4, spv::OpDecorate), 5, spv::DecorationBinding, 4,
+        FirstWord(4, spv::OpTypeInt), 1, 32, 0,
+        FirstWord(3, spv::OpTypeStruct), 2, 1,
+        FirstWord(4, spv::OpTypePointer), 6, spv::StorageClassPhysicalStorageBuffer, 2,
+        FirstWord(3, spv::OpTypeStruct), 3, 6,
+        FirstWord(4, spv::OpTypePointer), 4, spv::StorageClassStorageBuffer, 3,
+        FirstWord(4, spv::OpVariable), 4, 5, spv::StorageClassStorageBuffer,
+    };
+    words.insert(words.end(), body.begin(), body.end());
+    return words;
+}
+
+void TestThreadPoolExceptions() {
+    // one task throws, every other task still runs once and the exception comes out of Run()
+    std::vector<size_t> order(100);
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = order.size() - 1 - i;
+    }
+    std::vector<std::atomic<int>> runs(order.size());
+    bool rethrown = false;
+    try {
+        SpirVThreadPool(4).Run(order, [&](size_t, size_t task_index) {
+            runs[task_index]++;
+            if (task_index == 42) {
+                throw std::runtime_error("task 42");
+            }
+        });
+    } catch (const std::runtime_error& exception) {
+        rethrown = strcmp(exception.what(), "task 42") == 0;
+    }
+    CHECK(rethrown);
+    CHECK(std::all_of(runs.begin(), runs.end(), [](const std::atomic<int>& count) { return count == 1; }));
+}
+
+// a vertex shader storing Position twice from a Function variable that only gets its Input (Location 1) in between
+std::vector<uint32_t> ModuleWithLaterStore() {
+    std::vector<uint32_t> words = {spv::MagicNumber, 0x00010000, 0, 15, 0};
+    const std::vector<uint32_t> body = {
+        FirstWord(2, spv::OpCapability), spv::CapabilityShader,
+        FirstWord(3, spv::OpMemoryModel), spv::AddressingModelLogical, spv::MemoryModelGLSL450,
+        FirstWord(7, spv::OpEntryPoint), spv::ExecutionModelVertex, 10, PackChars("main"), 0, 8, 9,
+        FirstWord(4, spv::OpDecorate), 8, spv::DecorationBuiltIn, spv::BuiltInPosition,
+        FirstWord(4, spv::OpDecorate), 9, spv::DecorationLocation, 1,
+        FirstWord(2, spv::OpTypeVoid), 1,
+        FirstWord(3, spv::OpTypeFunction), 2, 1,
+        FirstWord(3, spv::OpTypeFloat), 3, 32,
+        FirstWord(4, spv::OpTypeVector), 4, 3, 4,
+        FirstWord(4, spv::OpTypePointer), 5, spv::StorageClassOutput, 4,
+        FirstWord(4, spv::OpTypePointer), 6, spv::StorageClassInput, 4,
+        FirstWord(4, spv::OpTypePointer), 7, spv::StorageClassFunction, 4,
+        FirstWord(4, spv::OpVariable), 5, 8, spv::StorageClassOutput,
+        FirstWord(4, spv::OpVariable), 6, 9, spv::StorageClassInput,
+        FirstWord(5, spv::OpFunction), 1, 10, spv::FunctionControlMaskNone, 2,
+        FirstWord(2, spv::OpLabel), 11,
+        FirstWord(4, spv::OpVariable), 7, 12, spv::StorageClassFunction,
+        FirstWord(4, spv::OpLoad), 4, 13, 12,
+        FirstWord(3, spv::OpStore), 8, 13,
+        FirstWord(4, spv::OpLoad), 4, 14, 9,
+        FirstWord(3, spv::OpStore), 12, 14,
+        FirstWord(3, spv::OpStore), 8, 13,
+        FirstWord(1, spv::OpReturn),
+        FirstWord(1, spv::OpFunctionEnd),
+    };
+    words.insert(words.end(), body.begin(), body.end());
+    return words;
+}
+
+void TestVertexLaterStore() {
+    // the first Position store searches %13 before %12 is stored to, the second must still see the Input behind it
+    const std::vector<uint32_t> words = ModuleWithLaterStore();
+    VertexInputPositionAnalyzer analyzer;
+    CHECK(analyzer.Analyze(words.data(), words.size() * sizeof(uint32_t)));
+    const VertexInputPositionAnalyzer::Result& result = analyzer.GetResult();
+    CHECK(result.status == VertexInputPositionAnalyzer::Status::SUCCESS);
+    CHECK(result.locations == std::vector<uint32_t>{1});
+
+    // the same analyzer again, its memo and store lists start over
+    CHECK(analyzer.Analyze(words.data(), words.size() * sizeof(uint32_t)));
+    CHECK(analyzer.GetResult().locations == std::vector<uint32_t>{1});
+}
+
+// gl_PerVertex { vec4 gl_Position; float gl_PointSize; } with Position from Location 1 and the point size from
+// Location 2
+std::vector<uint32_t> ModuleWithPerVertexBlock() {
+    std::vector<uint32_t> words = {spv::MagicNumber, 0x00010000, 0, 25, 0};
+    const std::vector<uint32_t> body = {
+        FirstWord(2, spv::OpCapability), spv::CapabilityShader,
+        FirstWord(3, spv::OpMemoryModel), spv::AddressingModelLogical, spv::MemoryModelGLSL450,
+        FirstWord(8, spv::OpEntryPoint), spv::ExecutionModelVertex, 10, PackChars("main"), 0, 8, 9, 15,
+        FirstWord(5, spv::OpMemberDecorate), 6, 0, spv::DecorationBuiltIn, spv::BuiltInPosition,
+        FirstWord(5, spv::OpMemberDecorate), 6, 1, spv::DecorationBuiltIn, spv::BuiltInPointSize,
+        FirstWord(3, spv::OpDecorate), 6, spv::DecorationBlock,
+        FirstWord(4, spv::OpDecorate), 9, spv::DecorationLocation, 1,
+        FirstWord(4, spv::OpDecorate), 15, spv::DecorationLocation, 2,
+        FirstWord(2, spv::OpTypeVoid), 1,
+        FirstWord(3, spv::OpTypeFunction), 2, 1,
+        FirstWord(3, spv::OpTypeFloat), 3, 32,
+        FirstWord(4, spv::OpTypeVector), 4, 3, 4,
+        FirstWord(4, spv::OpTypeInt), 5, 32, 1,
+        FirstWord(4, spv::OpTypeStruct), 6, 4, 3,
+        FirstWord(4, spv::OpTypePointer), 7, spv::StorageClassOutput, 6,
+        FirstWord(4, spv::OpTypePointer), 11, spv::StorageClassInput, 4,
+        FirstWord(4, spv::OpTypePointer), 12, spv::StorageClassOutput, 4,
+        FirstWord(4, spv::OpTypePointer), 13, spv::StorageClassInput, 3,
+        FirstWord(4, spv::OpTypePointer), 14, spv::StorageClassOutput, 3,
+        FirstWord(4, spv::OpConstant), 5, 16, 0,
+        FirstWord(4, spv::OpConstant), 5, 17, 1,
+        FirstWord(4, spv::OpVariable), 7, 8, spv::StorageClassOutput,
+        FirstWord(4, spv::OpVariable), 11, 9, spv::StorageClassInput,
+        FirstWord(4, spv::OpVariable), 13, 15, spv::StorageClassInput,
+        FirstWord(5, spv::OpFunction), 1, 10, spv::FunctionControlMaskNone, 2,
+        FirstWord(2, spv::OpLabel), 18,
+        FirstWord(4, spv::OpLoad), 4, 19, 9,
+        FirstWord(5, spv::OpAccessChain), 12, 20, 8, 16,
+        FirstWord(3, spv::OpStore), 20, 19,
+        FirstWord(4, spv::OpLoad), 3, 21, 15,
+        FirstWord(5, spv::OpAccessChain), 14, 22, 8, 17,
+        FirstWord(3, spv::OpStore), 22, 21,
+        FirstWord(1, spv::OpReturn),
+        FirstWord(1, spv::OpFunctionEnd),
+    };
+    words.insert(words.end(), body.begin(), body.end());
+    return words;
+}
+
+void TestVertexPerVertexBlock() {
+    // only the store through the Position member counts, gl_PointSize shares the block but not the builtin
+    const std::vector<uint32_t> words = ModuleWithPerVertexBlock();
+    VertexInputPositionAnalyzer analyzer;
+    CHECK(analyzer.Analyze(words.data(), words.size() * sizeof(uint32_t)));
+    CHECK(analyzer.GetResult().locations == std::vector<uint32_t>{1});
+}
+
+#if defined(__linux__)
+// a memfd holding 'words', sealed against shrinking and writing if asked to
+int CreateModuleDescriptor(const std::vector<uint32_t>& words, bool seal) {
+    const int descriptor = memfd_create("spirv_format_tests", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    const size_t num_bytes = words.size() * sizeof(uint32_t);
+    if (descriptor < 0) {
+        return -1;
+    }
+    if (write(descriptor, words.data(), num_bytes) != static_cast<ssize_t>(num_bytes) ||
+        (seal && fcntl(descriptor, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0)) {
+        close(descriptor);
+        return -1;
+    }
+    return descriptor;
+}
+
+void TestDescriptorResults() {
+    using Record = SpirVParsingUtil::BufferReferenceRecord;
+    SpirVParsingUtil parsing_util;
+    Record storage[4] = {};
+    SpirVResultRing<Record> results(storage, 4);
+    Record record;
+
+    const int sealed = CreateModuleDescriptor(ModuleWithBufferReference(), true);
+    CHECK(sealed >= 0);
+    CHECK(parsing_util.FindBufferReferences(sealed, 42, results));
+    CHECK(results.size() == 2);
+    CHECK(results.TryPop(record));
+    CHECK(record.module_tag == 42 && record.kind == Record::Kind::BUFFER_REFERENCE);
+    CHECK(record.info.source == SpirVParsingUtil::BufferReferenceLocation::STORAGE_BUFFER);
+    CHECK(record.info.set == 1 && record.info.binding == 4 && record.info.buffer_offset == 0);
+    CHECK(results.TryPop(record));
+    CHECK(record.module_tag == 42 && record.kind == Record::Kind::END_OF_MODULE);
+    CHECK(record.success == 1 && record.num_references == 1);
+
+    // the names outlive the mapping
+    SpirVBufferReferenceFileWriter writer;
+    parsing_util.WriteBufferReferences(writer);
+    std::vector<uint8_t> bytes;
+    writer.Finish(bytes);
+    SpirVBufferReferenceFileReader reader;
+    CHECK(reader.Open(bytes.data(), bytes.size()) && reader.size() == 1);
+    CHECK(reader.size() == 1 && reader.GetChainLength(0) == 1 && strcmp(reader.GetChainName(0, 0), "ptr") == 0);
+
+    // a ring too small for the module keeps what fits and counts the rest, the end marker included
+    Record small_storage[1] = {};
+    SpirVResultRing<Record> small_results(small_storage, 1);
+    CHECK(parsing_util.FindBufferReferences(sealed, 43, small_results));
+    CHECK(small_results.size() == 1 && small_results.dropped() == 1);
+    close(sealed);
+
+    // unsealed descriptors can change under the analysis, they are refused without being mapped
+    const int unsealed = CreateModuleDescriptor(ModuleWithBufferReference(), false);
+    CHECK(unsealed >= 0);
+    CHECK(!parsing_util.FindBufferReferences(unsealed, 44, results));
+    CHECK(results.TryPop(record));
+    CHECK(record.module_tag == 44 && record.kind == Record::Kind::END_OF_MODULE && record.success == 0);
+    CHECK(!results.TryPop(record));
+    close(unsealed);
+
+    CHECK(!parsing_util.FindBufferReferences(-1, 45, results));
+    CHECK(results.TryPop(record) && record.module_tag == 45 && record.success == 0);
+}
+#endif
+
+}  // namespace
+
+int main() {
+    TestHash();
+    TestReferenceFileRoundTrip();
+    TestReferenceFileRejectsDamage();
+    TestNdjsonEscaping();
+    TestResultRing();
+    TestThreadPoolExceptions();
+    TestUnterminatedNames();
+    TestVertexLaterStore();
+    TestVertexPerVertexBlock();
+#if defined(__linux__)
+    TestDescriptorResults();
+#endif
+
+    if (g_num_failures > 0) {
+        fprintf(stderr, "%d checks failed\n", g_num_failures);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,478 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#include "vertex_input_position_analyzer.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "helper.h"
+#include "spirv_instruction.h"
+#include "spirv_scanner.h"
+
+SpirVInstruction VertexInputPositionAnalyzer::FindDef(uint32_t id) const
+{
+    return instructions_.FindDef(id);
+}
+
+const uint32_t* VertexInputPositionAnalyzer::FindInputLocation(uint32_t id) const
+{
+    // Returns the Location of an Input variable, or nullptr if the ID is not one
+    Instruction variable = FindDef(id);
+    if (!variable || variable.opcode() != spv::OpVariable || variable.operand(0) != spv::StorageClassInput)
+    {
+        return nullptr;
+    }
+    const SpirVDecorationIndex::Decorations* variable_decorations = decorations_.Find(id);
+    if (!variable_decorations || !variable_decorations->has(SpirVDecorationIndex::Decorations::LOCATION))
+    {
+        return nullptr;
+    }
+    return &variable_decorations->location;
+}
+
+void VertexInputPositionAnalyzer::GetSearchOperands(uint32_t id)
+{
+    search_operands_.clear();
+    Instruction insn = FindDef(id);
+    if (!insn)
+    {
+        return;
+    }
+
+    switch (insn.opcode())
+    {
+        case spv::OpLoad:
+        {
+            // a load from an Input variable is where the search stops
+            if (FindInputLocation(insn.operand(0)))
+            {
+                return;
+            }
+            const uint32_t pointer_id = insn.operand(0);
+            if (pointer_id >= stored_objects_.size())
+            {
+                return;
+            }
+            for (uint32_t entry = stored_objects_[pointer_id]; entry != 0; entry = store_entries_[entry - 1].previous)
+            {
+                search_operands_.push_back(store_entries_[entry - 1].object_id);
+            }
+            return;
+        }
+        case spv::OpCompositeExtract:
+            search_operands_.push_back(insn.operand(0));
+            return;
+        case spv::OpVectorTimesScalar:
+        case spv::OpMatrixTimesScalar:
+        case spv::OpVectorTimesMatrix:
+        case spv::OpMatrixTimesVector:
+        case spv::OpMatrixTimesMatrix:
+            search_operands_.push_back(insn.operand(0));
+            search_operands_.push_back(insn.operand(1));
+            return;
+        case spv::OpCompositeConstruct:
+            for (uint32_t i = 3; i < insn.length(); i++)
+            {
+                search_operands_.push_back(insn.word(i));
+            }
+            return;
+        default:
+            return;
+    }
+}
+
+void VertexInputPositionAnalyzer::FinishSearch(uint32_t id)
+{
+    search_state_[id] = DONE;
+
+    Instruction insn = FindDef(id);
+    if (!insn)
+    {
+        return;
+    }
+
+    switch (insn.opcode())
+    {
+        case spv::OpLoad:
+        case spv::OpCompositeExtract:
+        case spv::OpVectorTimesScalar:
+        case spv::OpMatrixTimesScalar:
+        case spv::OpVectorTimesMatrix:
+        case spv::OpMatrixTimesVector:
+        case spv::OpMatrixTimesMatrix:
+        case spv::OpCompositeConstruct:
+            break;
+        case spv::OpConstant:
+        case spv::OpConstantNull:
+            return;
+        default:
+            result_.unsupported_instructions.push_back({insn.opcode(), insn.resultId()});
+            return;
+    }
+
+    if (insn.opcode() == spv::OpLoad)
+    {
+        if (const uint32_t* location = FindInputLocation(insn.operand(0)))
+        {
+            result_.input_loads.push_back({*location, insn.resultId()});
+            search_location_set_[id] = NewLocationSet();
+            location_sets_[search_location_set_[id]].push_back(*location);
+            return;
+        }
+    }
+
+    // operands still in progress are part of a cycle through a store, they add nothing that isn't found already
+    uint32_t merged_set = 0;
+    GetSearchOperands(id);
+    for (uint32_t operand_id : search_operands_)
+    {
+        const uint32_t operand_set = operand_id < search_state_.size() && search_state_[operand_id] == DONE
+                                         ? search_location_set_[operand_id]
+                                         : 0;
+        if (operand_set == 0 || operand_set == merged_set)
+        {
+            continue;
+        }
+        if (merged_set == 0)
+        {
+            // share the operand's set until something needs to be added to it
+            merged_set = operand_set;
+            continue;
+        }
+
+        std::vector<uint32_t>& merged = merge_scratch_;
+        merged.clear();
+        std::set_union(location_sets_[merged_set].begin(),
+                       location_sets_[merged_set].end(),
+                       location_sets_[operand_set].begin(),
+                       location_sets_[operand_set].end(),
+                       std::back_inserter(merged));
+        if (merged.size() == location_sets_[merged_set].size())
+        {
+            continue;
+        }
+        if (merged.size() == location_sets_[operand_set].size())
+        {
+            merged_set = operand_set;
+            continue;
+        }
+        merged_set = NewLocationSet();
+        location_sets_[merged_set].swap(merged);
+    }
+    search_location_set_[id] = merged_set;
+}
+
+void VertexInputPositionAnalyzer::Search(uint32_t id)
+{
+    if (id >= search_state_.size())
+    {
+        return;
+    }
+
+    search_stack_.clear();
+    search_stack_.push_back({id, false});
+    while (!search_stack_.empty())
+    {
+        SearchFrame& frame = search_stack_.back();
+        const uint32_t frame_id = frame.id;
+        if (frame_id >= search_state_.size())
+        {
+            search_stack_.pop_back();
+            continue;
+        }
+
+        if (frame.operands_pushed)
+        {
+            search_stack_.pop_back();
+            FinishSearch(frame_id);
+            continue;
+        }
+        if (search_state_[frame_id] != NOT_VISITED)
+        {
+            search_stack_.pop_back();
+            continue;
+        }
+
+        // revisit this frame once every operand is done
+        frame.operands_pushed   = true;
+        search_state_[frame_id] = IN_PROGRESS;
+        GetSearchOperands(frame_id);
+        for (auto it = search_operands_.rbegin(); it != search_operands_.rend(); ++it)
+        {
+            if (*it < search_state_.size() && search_state_[*it] == NOT_VISITED)
+            {
+                search_stack_.push_back({*it, false});
+            }
+        }
+    }
+
+    // the Locations stored to Position through this value
+    const std::vector<uint32_t>& found  = location_sets_[search_location_set_[id]];
+    std::vector<uint32_t>&       merged = merge_scratch_;
+    merged.clear();
+    std::set_union(result_.locations.begin(), result_.locations.end(), found.begin(), found.end(), std::back_inserter(merged));
+    result_.locations.swap(merged);
+}
+
+uint32_t VertexInputPositionAnalyzer::NewLocationSet()
+{
+    // the sets of earlier modules are recycled, so their memory is reused as well
+    if (num_location_sets_ == location_sets_.size())
+    {
+        location_sets_.emplace_back();
+    }
+    location_sets_[num_location_sets_].clear();
+    return static_cast<uint32_t>(num_location_sets_++);
+}
+
+size_t VertexInputPositionAnalyzer::used_bytes() const
+{
+    return instructions_.used_bytes() + decorations_.used_bytes() + stored_objects_.size() * sizeof(uint32_t) +
+           store_entries_.size() * sizeof(StoreEntry) + search_state_.size() * sizeof(uint8_t) +
+           search_location_set_.size() * sizeof(uint32_t) + num_location_sets_ * sizeof(std::vector<uint32_t>);
+}
+
+size_t VertexInputPositionAnalyzer::retained_bytes() const
+{
+    return instructions_.retained_bytes() + decorations_.retained_bytes() +
+           stored_objects_.capacity() * sizeof(uint32_t) + store_entries_.capacity() * sizeof(StoreEntry) +
+           search_state_.capacity() * sizeof(uint8_t) + search_location_set_.capacity() * sizeof(uint32_t) +
+           location_sets_.capacity() * sizeof(std::vector<uint32_t>);
+}
+
+void VertexInputPositionAnalyzer::ShrinkToFit()
+{
+    instructions_.ShrinkToFit();
+    decorations_.ShrinkToFit();
+    stored_objects_.shrink_to_fit();
+    store_entries_.shrink_to_fit();
+    search_state_.shrink_to_fit();
+    search_location_set_.shrink_to_fit();
+    location_sets_.resize(num_location_sets_);
+    location_sets_.shrink_to_fit();
+    search_stack_.shrink_to_fit();
+    search_operands_.shrink_to_fit();
+    position_stores_.shrink_to_fit();
+    merge_scratch_.shrink_to_fit();
+}
+
+bool VertexInputPositionAnalyzer::Analyze(const uint32_t* spirv_code, size_t spirv_num_bytes)
+{
+    // the previous module's tables are still in place, so this is where it is known how much they needed
+    if (retention_policy_.Update(used_bytes(), retained_bytes()))
+    {
+        ShrinkToFit();
+    }
+
+    // cleared rather than replaced, so the vectors keep their memory
+    result_.status = Status::SUCCESS;
+    result_.locations.clear();
+    result_.input_loads.clear();
+    result_.unsupported_instructions.clear();
+
+    // First build up the instruction table to make it easier to work with the SPIR-V
+    if (instructions_.Build(spirv_code, spirv_num_bytes) != SpirVInstructionTable::Status::SUCCESS)
+    {
+        result_.status = Status::INVALID_MODULE;
+        return false;
+    }
+
+    // only the opcode column is touched until an entry point shows up
+    bool                         has_vertex_entry_point = false;
+    const std::vector<uint32_t>& opcodes                = instructions_.opcodes();
+    for (size_t i = SpirVScanner::FindOpcode(opcodes.data(), opcodes.size(), spv::OpEntryPoint);
+         i < opcodes.size() && !has_vertex_entry_point;
+         i = SpirVScanner::FindOpcode(opcodes.data(), opcodes.size(), spv::OpEntryPoint, i + 1))
+    {
+        has_vertex_entry_point = instructions_[i].operand(0) == spv::ExecutionModelVertex;
+    }
+    if (!has_vertex_entry_point)
+    {
+        result_.status = Status::NOT_VERTEX_SHADER;
+        return true;
+    }
+
+    const uint32_t id_bound = instructions_.id_bound();
+    decorations_.Reset(id_bound);
+    stored_objects_.assign(id_bound, 0);
+    store_entries_.clear();
+    search_state_.assign(id_bound, NOT_VISITED);
+    search_location_set_.assign(id_bound, 0);
+    num_location_sets_ = 0;
+    NewLocationSet();
+    position_stores_.clear();
+
+    // There are VU to make sure the Position BuiltIn is only used once. In a block (gl_PerVertex) only stores through
+    // the Position member count, not the ones to gl_PointSize or gl_ClipDistance next to it
+    uint32_t position_var          = 0;
+    bool     position_in_block     = false;
+    uint32_t position_member_index = 0;
+
+    // Now we can walk the SPIR-V one more time to find what we need
+    for (Instruction insn : instructions_)
+    {
+        const uint32_t opcode = insn.opcode();
+
+        // First find the Position builtin
+        if (opcode == spv::OpDecorate)
+        {
+            const uint32_t value = insn.length() > 3 ? insn.operand(2) : 0;
+            decorations_.AddDecoration(insn.operand(0), insn.operand(1), value);
+            if (insn.operand(1) == spv::DecorationBuiltIn && value == spv::BuiltInPosition)
+            {
+                position_var      = insn.operand(0);
+                position_in_block = false;
+            }
+        }
+        else if (opcode == spv::OpMemberDecorate)
+        {
+            const uint32_t value = insn.length() > 4 ? insn.operand(3) : 0;
+            decorations_.AddMemberDecoration(insn.operand(0), insn.operand(1), insn.operand(2), value);
+            if (insn.operand(2) == spv::DecorationBuiltIn && value == spv::BuiltInPosition)
+            {
+                position_var          = insn.operand(0);  // actually OpTypeStruct, resolve below
+                position_in_block     = true;
+                position_member_index = insn.operand(1);
+            }
+        }
+
+        // Find the variable it is tied to if Position is in a block
+        if (opcode == spv::OpVariable && insn.operand(0) == spv::StorageClassOutput)
+        {
+            Instruction pointer_type = FindDef(insn.typeId());
+            if (pointer_type && pointer_type.opcode() == spv::OpTypePointer)
+            {
+                if (pointer_type.operand(1) == position_var)
+                {
+                    position_var = insn.resultId();
+                }
+            }
+        }
+
+        if (opcode != spv::OpStore)
+        {
+            continue;
+        }
+        if (insn.operand(0) < stored_objects_.size())
+        {
+            store_entries_.push_back({insn.operand(1), stored_objects_[insn.operand(0)]});
+            stored_objects_[insn.operand(0)] = static_cast<uint32_t>(store_entries_.size());
+        }
+
+        // Check if OpStore is writing to Position or not
+        if (insn.operand(0) != position_var)
+        {
+            // if in a block, will have an access chain
+            Instruction access_chain = FindDef(insn.operand(0));
+            if (!access_chain || access_chain.opcode() != spv::OpAccessChain || access_chain.operand(0) != position_var)
+            {
+                continue;
+            }
+            // struct members are always selected by a constant
+            if (position_in_block)
+            {
+                Instruction member = access_chain.num_operands() > 1 ? FindDef(access_chain.operand(1)) : Instruction();
+                if (!member || member.opcode() != spv::OpConstant || member.operand(0) != position_member_index)
+                {
+                    continue;
+                }
+            }
+        }
+
+        // We have spotted where the Position was written
+        position_stores_.push_back(insn.operand(1));
+    }
+
+    // now work backward to see if we can find any Input Locations that was involved. Only once every OpStore is in
+    // stored_objects_: a value is memoized when it is first searched and must not miss a store further down
+    for (const uint32_t object_id : position_stores_)
+    {
+        Search(object_id);
+    }
+    return true;
+}
+
+void VertexInputPositionAnalyzer::PrintResult(FILE* output) const
+{
+    if (result_.status == Status::NOT_VERTEX_SHADER)
+    {
+        fprintf(output, "Not a vertex shader, so no Position builtin to find\n");
+    }
+    else if (result_.status == Status::INVALID_MODULE)
+    {
+        fprintf(output, "Invalid SPIR-V module\n");
+    }
+    for (const InputLoad& input_load : result_.input_loads)
+    {
+        fprintf(output, "Position is stored using Input Location %u (OpLoad %%%u)\n", input_load.location, input_load.load_id);
+    }
+    for (const UnsupportedInstruction& insn : result_.unsupported_instructions)
+    {
+        fprintf(output, "Unsupported instruction %s\n", string_SpvOpcode(insn.opcode));
+    }
+}
+
+void VertexInputPositionAnalyzer::EmitResult(SpirVNdjsonWriter& writer) const
+{
+    writer.BeginObject();
+    writer.String("type", "vertex-input-position");
+
+    switch (result_.status)
+    {
+        case Status::SUCCESS:
+            writer.String("status", "success");
+            break;
+        case Status::NOT_VERTEX_SHADER:
+            writer.String("status", "not-vertex-shader");
+            break;
+        case Status::INVALID_MODULE:
+            writer.String("status", "invalid-module");
+            break;
+    }
+
+    writer.BeginArray("locations");
+    for (const uint32_t location : result_.locations)
+    {
+        writer.UInt(location);
+    }
+    writer.EndArray();
+
+    writer.BeginArray("input_loads");
+    for (const InputLoad& input_load : result_.input_loads)
+    {
+        writer.BeginObject();
+        writer.UInt("location", input_load.location);
+        writer.UInt("load_id", input_load.load_id);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.BeginArray("unsupported_instructions");
+    for (const UnsupportedInstruction& insn : result_.unsupported_instructions)
+    {
+        writer.String(string_SpvOpcode(insn.opcode));
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+}
@@ -0,0 +1,176 @@
+/*
+** Copyright (c) 2024 LunarG, Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and associated documentation files (the "Software"),
+** to deal in the Software without restriction, including without limitation
+** the rights to use, copy, modify, merge, publish, distribute, sublicense,
+** and/or sell copies of the Software, and to permit persons to whom the
+** Software is furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SPIRV_PARSING_VERTEX_INPUT_POSITION_ANALYZER_H
+#define SPIRV_PARSING_VERTEX_INPUT_POSITION_ANALYZER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "spirv_decoration_index.h"
+#include "spirv_instruction.h"
+#include "spirv_ndjson_writer.h"
+#include "spirv_retention_policy.h"
+
+// VertexInputPositionAnalyzer finds which vertex input Locations are used to write the Position built-in.
+//
+// All state lives in the instance, so one analyzer can be reused for many modules and separate instances can run on
+// separate threads. Nothing is printed, the findings are returned through GetResult().
+class VertexInputPositionAnalyzer
+{
+  public:
+    enum class Status
+    {
+        SUCCESS = 0,
+
+        //! the module has no Vertex entry point, so there is no Position built-in to find
+        NOT_VERTEX_SHADER,
+
+        //! the module is too small or its header/instruction lengths are inconsistent
+        INVALID_MODULE
+    };
+
+    //! an OpLoad from an Input variable that contributed to the value stored to Position
+    struct InputLoad
+    {
+        uint32_t location = 0;
+        uint32_t load_id  = 0;
+    };
+
+    //! an instruction on the way back from Position that the analyzer can't look through
+    struct UnsupportedInstruction
+    {
+        uint32_t opcode    = 0;
+        uint32_t result_id = 0;
+    };
+
+    struct Result
+    {
+        Status status = Status::SUCCESS;
+
+        //! unique Locations found, sorted
+        std::vector<uint32_t> locations;
+
+        //! every load found, in the order they were reached (each load once, however many paths lead to it)
+        std::vector<InputLoad> input_loads;
+
+        //! each instruction once, however many paths lead to it
+        std::vector<UnsupportedInstruction> unsupported_instructions;
+    };
+
+    //! version of the printed results, part of the result-cache key. Bump whenever the output changes
+    static constexpr uint32_t kResultVersion = 3;
+
+    //! analyze a module, the previous result is replaced. Returns false if the module could not be analyzed
+    bool Analyze(const uint32_t* spirv_code, size_t spirv_num_bytes);
+
+    [[nodiscard]] const Result& GetResult() const { return result_; }
+
+    //! print the result of the last Analyze() in the tool's format
+    void PrintResult(FILE* output) const;
+
+    //! the result of the last Analyze() as one NDJSON record
+    void EmitResult(SpirVNdjsonWriter& writer) const;
+
+    //! The tables are kept between modules, see SpirVRetentionPolicy. By default the memory is never given back
+    void SetRetentionPolicy(const SpirVRetentionPolicy& policy) { retention_policy_ = policy; }
+
+    //! bytes held by the tables of the last module
+    [[nodiscard]] size_t retained_bytes() const;
+
+    //! shrink the tables to what the last module needed
+    void ShrinkToFit();
+
+  private:
+    using Instruction = SpirVInstruction;
+
+    [[nodiscard]] Instruction     FindDef(uint32_t id) const;
+    [[nodiscard]] const uint32_t* FindInputLocation(uint32_t id) const;
+
+    // work backward from the value stored to Position, recording any Input Locations that were involved
+    void Search(uint32_t id);
+
+    // the IDs whose locations flow into 'id' (nothing for leaves), filled into search_operands_
+    void GetSearchOperands(uint32_t id);
+
+    // merge the location sets of the operands into the set of 'id', once all operands were searched
+    void FinishSearch(uint32_t id);
+
+    // index of a new, empty entry of location_sets_
+    uint32_t NewLocationSet();
+
+    [[nodiscard]] size_t used_bytes() const;
+
+    Result result_{};
+
+    // the module's instructions, also the LUT for hopping around instructions from a result ID
+    SpirVInstructionTable instructions_{};
+
+    // Location/BuiltIn decorations per ID
+    SpirVDecorationIndex decorations_{};
+
+    // every OpStore per pointer ID, as a list through store_entries_: index + 1 of the pointer's last store, 0 if it
+    // was never stored to. A load may see any of them, so the search follows all
+    struct StoreEntry
+    {
+        uint32_t object_id;
+        uint32_t previous;  // index + 1 of the same pointer's earlier store, 0 for the first
+    };
+    std::vector<uint32_t>   stored_objects_{};
+    std::vector<StoreEntry> store_entries_{};
+
+    // Search memo, per ID. A value reachable along many paths (ubo.projection * ubo.model used several times) is only
+    // walked once, so the search is linear in the number of reachable definitions
+    enum SearchState : uint8_t
+    {
+        NOT_VISITED = 0,
+        IN_PROGRESS,
+        DONE
+    };
+    std::vector<uint8_t> search_state_{};
+
+    // index into location_sets_ per ID, sets are shared when a value just passes its operand's locations through
+    std::vector<uint32_t> search_location_set_{};
+
+    // sorted unique Locations, [0] is the empty set. Only the first num_location_sets_ belong to the current module
+    std::vector<std::vector<uint32_t>> location_sets_{};
+    size_t                             num_location_sets_ = 0;
+    std::vector<uint32_t>              merge_scratch_{};
+
+    // explicit worklist instead of recursion, so deep expressions can't overflow the stack
+    struct SearchFrame
+    {
+        uint32_t id;
+        bool     operands_pushed;
+    };
+    std::vector<SearchFrame> search_stack_{};
+    std::vector<uint32_t>    search_operands_{};
+
+    // the objects stored to Position, searched once the whole module has been walked
+    std::vector<uint32_t> position_stores_{};
+
+    SpirVRetentionPolicy retention_policy_{};
+};
+
+#endif // SPIRV_PARSING_VERTEX_INPUT_POSITION_ANALYZER_H